@@ -79,6 +79,7 @@ AddonsManager::AddonsManager(QObject *parent) : QObject(parent)
 	SettingsManager::setDefinition(QLatin1String("Backends/Web"), backends);
 
 	registerSpecialPage(SpecialPageInformation(tr("Addons Manager"), QString(), QUrl(QLatin1String("about:addons")), ThemesManager::getIcon(QLatin1String("preferences-plugin"), false)), QLatin1String("addons"));
+	registerSpecialPage(SpecialPageInformation(tr("Content Blocking Statistics"), QString(), QUrl(QLatin1String("about:blocking")), ThemesManager::getIcon(QLatin1String("content-blocking"), false)), QLatin1String("blocking"));
 	registerSpecialPage(SpecialPageInformation(tr("Bookmarks Manager"), QString(), QUrl(QLatin1String("about:bookmarks")), ThemesManager::getIcon(QLatin1String("bookmarks"), false)), QLatin1String("bookmarks"));
 	registerSpecialPage(SpecialPageInformation(tr("Cache Manager"), QString(), QUrl(QLatin1String("about:cache")), ThemesManager::getIcon(QLatin1String("cache"), false)), QLatin1String("cache"));
 	registerSpecialPage(SpecialPageInformation(tr("Configuration Manager"), QString(), QUrl(QLatin1String("about:config")), ThemesManager::getIcon(QLatin1String("configuration"), false)), QLatin1String("configuration"));
@@ -23,9 +23,12 @@
 #include "AddonsManager.h"
 #include "BookmarksManager.h"
 #include "Console.h"
+#include "ContentBlockingBenchmark.h"
+#include "ContentBlockingManager.h"
 #include "GesturesManager.h"
 #include "HandlersManager.h"
 #include "HistoryManager.h"
+#include "HostResolver.h"
 #include "LongTermTimer.h"
 #include "NetworkManagerFactory.h"
 #include "NotesManager.h"
@@ -35,6 +38,7 @@
 #include "SearchEnginesManager.h"
 #include "SettingsManager.h"
 #include "SpellCheckManager.h"
+#include "StartupTrace.h"
 #include "ToolBarsManager.h"
 #include "ThemesManager.h"
 #include "TransfersManager.h"
@@ -56,6 +60,7 @@
 
 #include <QtCore/QBuffer>
 #include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
@@ -63,6 +68,7 @@
 #include <QtCore/QLocale>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
 #if QT_VERSION >= 0x050400
 #include <QtCore/QStorageInfo>
 #endif
@@ -74,6 +80,9 @@
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QStyleFactory>
 
+#define APPLICATION_MAXIMUM_MESSAGE_SIZE 16777216
+#define APPLICATION_CONNECTION_TIMEOUT 5000
+
 namespace Otter
 {
 
@@ -86,6 +95,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 	m_applicationTranslator(NULL),
 	m_localServer(NULL),
 	m_isHidden(false),
+	m_isProcessingScheduled(false),
 	m_isUpdating(false)
 {
 	setApplicationName(QLatin1String("Otter"));
@@ -111,6 +121,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 	m_commandLineParser.addVersionOption();
 	m_commandLineParser.addPositionalArgument(QLatin1String("url"), QCoreApplication::translate("main", "URL to open"), QLatin1String("[url]"));
 	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("cache"), QCoreApplication::translate("main", "Uses <path> as cache directory"), QLatin1String("path"), QString()));
+	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("content-blocking-benchmark"), QCoreApplication::translate("main", "Replays requests listed in <path> through content blocking profiles, prints timings and exits application"), QLatin1String("path"), QString()));
 	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("profile"), QCoreApplication::translate("main", "Uses <path> as profile directory"), QLatin1String("path"), QString()));
 	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("session"), QCoreApplication::translate("main", "Restores session <session> if it exists"), QLatin1String("session"), QString()));
 	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("privatesession"), QCoreApplication::translate("main", "Starts private session")));
@@ -118,6 +129,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("portable"), QCoreApplication::translate("main", "Sets profile and cache paths to directories inside the same directory as that of application binary")));
 	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("readonly"), QCoreApplication::translate("main", "Tells application to avoid writing data to disk")));
 	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("report"), QCoreApplication::translate("main", "Prints out diagnostic report and exits application")));
+	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("startup-trace"), QCoreApplication::translate("main", "Writes startup timings to <path> in Chrome trace format"), QLatin1String("path"), QString()));
 
 	QStringList arguments(this->arguments());
 	const QString argumentsPath(QDir::current().filePath(QLatin1String("arguments.txt")));
@@ -155,6 +167,11 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	m_commandLineParser.process(arguments);
 
+	if (m_commandLineParser.isSet(QLatin1String("startup-trace")))
+	{
+		StartupTrace::start(QFileInfo(m_commandLineParser.value(QLatin1String("startup-trace"))).absoluteFilePath());
+	}
+
 	const bool isPortable(m_commandLineParser.isSet(QLatin1String("portable")));
 	const bool isPrivate(m_commandLineParser.isSet(QLatin1String("privatesession")));
 	bool isReadOnly(m_commandLineParser.isSet(QLatin1String("readonly")));
@@ -203,6 +220,22 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 		return;
 	}
 
+	if (m_commandLineParser.isSet(QLatin1String("content-blocking-benchmark")))
+	{
+		Console::createInstance(this);
+
+		SettingsManager::createInstance(profilePath, this);
+
+		SessionsManager::createInstance(profilePath, cachePath, isPrivate, true, this);
+
+		ContentBlockingManager::createInstance(this, false);
+
+		QTextStream stream(stdout);
+		stream << ContentBlockingBenchmark::createReport(QFileInfo(m_commandLineParser.value(QLatin1String("content-blocking-benchmark"))).absoluteFilePath());
+
+		return;
+	}
+
 	QCryptographicHash hash(QCryptographicHash::Md5);
 	hash.addData(profilePath.toUtf8());
 
@@ -213,23 +246,20 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	if (socket.waitForConnected(500))
 	{
-		const QStringList decodedArguments = arguments;
-		QStringList encodedArguments;
-
 #ifdef Q_OS_WIN
 		AllowSetForegroundWindow(ASFW_ANY);
 #endif
 
-		for (int i = 0; i < decodedArguments.count(); ++i)
-		{
-			encodedArguments.append(decodedArguments.at(i).toUtf8().toBase64());
-		}
-
-		QTextStream stream(&socket);
-		stream << encodedArguments.join(QLatin1Char(' ')).toUtf8().toBase64();
-		stream.flush();
+		QByteArray message;
+		QDataStream stream(&message, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_3);
+		stream << quint32(0) << arguments;
+		stream.device()->seek(0);
+		stream << quint32(message.size() - sizeof(quint32));
 
+		socket.write(message);
 		socket.waitForBytesWritten();
+		socket.disconnectFromServer();
 
 		return;
 	}
@@ -255,9 +285,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 		isReadOnly = true;
 	}
 
-	Console::createInstance(this);
-
-	SettingsManager::createInstance(profilePath, this);
+	STARTUP_TRACE_MANAGER(Console, this);
+	STARTUP_TRACE_MANAGER(SettingsManager, profilePath, this);
 
 #if QT_VERSION >= 0x050400
 	if (!isReadOnly)
@@ -317,37 +346,28 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 	}
 #endif
 
-	SessionsManager::createInstance(profilePath, cachePath, isPrivate, isReadOnly, this);
-
-	ThemesManager::createInstance(this);
-
-	ActionsManager::createInstance(this);
-
-	AddonsManager::createInstance(this);
-
-	BookmarksManager::createInstance(this);
-
-	GesturesManager::createInstance(this);
-
-	HandlersManager::createInstance(this);
-
-	HistoryManager::createInstance(this);
-
-	NetworkManagerFactory::createInstance(this);
-
-	NotesManager::createInstance(this);
-
-	NotificationsManager::createInstance(this);
-
-	PasswordsManager::createInstance(this);
-
-	SearchEnginesManager::createInstance(this);
-
-	SpellCheckManager::createInstance(this);
-
-	ToolBarsManager::createInstance(this);
+	{
+		const StartupTraceScope managersTrace(QLatin1String("managers"));
+
+		STARTUP_TRACE_MANAGER(SessionsManager, profilePath, cachePath, isPrivate, isReadOnly, this);
+		STARTUP_TRACE_MANAGER(ThemesManager, this);
+		STARTUP_TRACE_MANAGER(ActionsManager, this);
+		STARTUP_TRACE_MANAGER(AddonsManager, this);
+		STARTUP_TRACE_MANAGER(BookmarksManager, this);
+		STARTUP_TRACE_MANAGER(GesturesManager, this);
+		STARTUP_TRACE_MANAGER(HandlersManager, this);
+		STARTUP_TRACE_MANAGER(HistoryManager, this);
+		STARTUP_TRACE_MANAGER(NetworkManagerFactory, this);
+		STARTUP_TRACE_MANAGER(NotesManager, this);
+		STARTUP_TRACE_MANAGER(NotificationsManager, this);
+		STARTUP_TRACE_MANAGER(PasswordsManager, this);
+		STARTUP_TRACE_MANAGER(SearchEnginesManager, this);
+		STARTUP_TRACE_MANAGER(SpellCheckManager, this);
+		STARTUP_TRACE_MANAGER(ToolBarsManager, this);
+		STARTUP_TRACE_MANAGER(TransfersManager, this);
+	}
 
-	TransfersManager::createInstance(this);
+	const StartupTraceScope initializationTrace(QLatin1String("initialization"));
 
 	setLocale(SettingsManager::getValue(QLatin1String("Browser/Locale")).toString());
 	setQuitOnLastWindowClosed(true);
@@ -378,6 +398,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 		if (m_isUpdating)
 		{
+			StartupTrace::save();
+
 			return;
 		}
 	}
@@ -485,55 +507,124 @@ void Application::showNotification(Notification *notification)
 
 void Application::newConnection()
 {
-	QLocalSocket *socket(m_localServer->nextPendingConnection());
+	while (m_localServer->hasPendingConnections())
+	{
+		QLocalSocket *socket(m_localServer->nextPendingConnection());
+
+		if (!socket)
+		{
+			break;
+		}
+
+		QTimer *timer(new QTimer(socket));
+		timer->setSingleShot(true);
+		timer->start(APPLICATION_CONNECTION_TIMEOUT);
+
+		connect(timer, SIGNAL(timeout()), socket, SLOT(deleteLater()));
+		connect(socket, SIGNAL(readyRead()), timer, SLOT(start()));
+		connect(socket, SIGNAL(readyRead()), this, SLOT(readConnection()));
+		connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+
+		if (socket->bytesAvailable() > 0)
+		{
+			readConnection(socket);
+		}
+	}
+}
+
+void Application::readConnection(QLocalSocket *socket)
+{
+	if (!socket)
+	{
+		socket = qobject_cast<QLocalSocket*>(sender());
+	}
 
 	if (!socket)
 	{
 		return;
 	}
 
-	socket->waitForReadyRead(1000);
+	while (socket->bytesAvailable() >= static_cast<qint64>(sizeof(quint32)))
+	{
+		quint32 length(0);
+		QDataStream lengthStream(socket->peek(sizeof(quint32)));
+		lengthStream.setVersion(QDataStream::Qt_5_3);
+		lengthStream >> length;
 
-	MainWindow *window(getWindows().isEmpty() ? NULL : getWindow());
-	QString data;
-	QTextStream stream(socket);
-	stream >> data;
+		if (length > APPLICATION_MAXIMUM_MESSAGE_SIZE)
+		{
+			socket->abort();
 
-	const QStringList encodedArguments(QString(QByteArray::fromBase64(data.toUtf8())).split(QLatin1Char(' ')));
-	QStringList decodedArguments;
+			return;
+		}
 
-	for (int i = 0; i < encodedArguments.count(); ++i)
-	{
-		decodedArguments.append(QString(QByteArray::fromBase64(encodedArguments.at(i).toUtf8())));
-	}
+		if (socket->bytesAvailable() < static_cast<qint64>(sizeof(quint32) + length))
+		{
+			return;
+		}
 
-	m_commandLineParser.parse(decodedArguments);
+		socket->read(sizeof(quint32));
 
-	const QString session(m_commandLineParser.value(QLatin1String("session")));
-	const bool isPrivate(m_commandLineParser.isSet(QLatin1String("privatesession")));
+		QStringList arguments;
+		QDataStream stream(socket->read(length));
+		stream.setVersion(QDataStream::Qt_5_3);
+		stream >> arguments;
 
-	if (session.isEmpty())
-	{
-		if (!window || !SettingsManager::getValue(QLatin1String("Browser/OpenLinksInNewTab")).toBool() || (isPrivate && !window->getWindowsManager()->isPrivate()))
+		if (stream.status() == QDataStream::Ok)
 		{
-			window = createWindow(isPrivate ? PrivateFlag : NoFlags);
+			m_pendingArguments.append(arguments);
 		}
 	}
-	else
+
+	if (!m_pendingArguments.isEmpty() && !m_isProcessingScheduled)
 	{
-		const SessionInformation sessionData(SessionsManager::getSession(session));
+		m_isProcessingScheduled = true;
 
-		if (sessionData.isClean || QMessageBox::warning(NULL, tr("Warning"), tr("This session was not saved correctly.\nAre you sure that you want to restore this session anyway?"), (QMessageBox::Yes | QMessageBox::No), QMessageBox::No) == QMessageBox::Yes)
+		QMetaObject::invokeMethod(this, "processArguments", Qt::QueuedConnection);
+	}
+}
+
+void Application::processArguments()
+{
+	const QList<QStringList> requests(m_pendingArguments);
+	MainWindow *activeWindow(NULL);
+
+	m_pendingArguments.clear();
+	m_isProcessingScheduled = false;
+
+	for (int i = 0; i < requests.count(); ++i)
+	{
+		m_commandLineParser.parse(requests.at(i));
+
+		MainWindow *window(getWindows().isEmpty() ? NULL : getWindow());
+		const QString session(m_commandLineParser.value(QLatin1String("session")));
+		const bool isPrivate(m_commandLineParser.isSet(QLatin1String("privatesession")));
+
+		if (session.isEmpty())
 		{
-			for (int i = 0; i < sessionData.windows.count(); ++i)
+			if (!window || !SettingsManager::getValue(QLatin1String("Browser/OpenLinksInNewTab")).toBool() || (isPrivate && !window->getWindowsManager()->isPrivate()))
 			{
-				createWindow((isPrivate ? PrivateFlag : NoFlags), false, sessionData.windows.at(i));
+				window = createWindow(isPrivate ? PrivateFlag : NoFlags);
 			}
 		}
-	}
+		else
+		{
+			const SessionInformation sessionData(SessionsManager::getSession(session));
+
+			if (sessionData.isClean || QMessageBox::warning(NULL, tr("Warning"), tr("This session was not saved correctly.\nAre you sure that you want to restore this session anyway?"), (QMessageBox::Yes | QMessageBox::No), QMessageBox::No) == QMessageBox::Yes)
+			{
+				for (int j = 0; j < sessionData.windows.count(); ++j)
+				{
+					createWindow((isPrivate ? PrivateFlag : NoFlags), false, sessionData.windows.at(j));
+				}
+			}
+		}
+
+		if (!window)
+		{
+			continue;
+		}
 
-	if (window)
-	{
 		if (m_commandLineParser.positionalArguments().isEmpty())
 		{
 			window->triggerAction(ActionsManager::NewTabAction);
@@ -542,19 +633,19 @@ void Application::newConnection()
 		{
 			const QStringList urls(m_commandLineParser.positionalArguments());
 
-			for (int i = 0; i < urls.count(); ++i)
+			for (int j = 0; j < urls.count(); ++j)
 			{
-				window->openUrl(urls.at(i));
+				window->openUrl(urls.at(j));
 			}
 		}
-	}
 
-	delete socket;
+		activeWindow = window;
+	}
 
-	if (window)
+	if (activeWindow)
 	{
-		window->raise();
-		window->activateWindow();
+		activeWindow->raise();
+		activeWindow->activateWindow();
 
 		if (m_isHidden)
 		{
@@ -562,7 +653,7 @@ void Application::newConnection()
 		}
 		else
 		{
-			window->raiseWindow();
+			activeWindow->raiseWindow();
 		}
 	}
 }
@@ -598,6 +689,16 @@ void Application::clearHistory()
 	}
 }
 
+void Application::saveStartupTrace()
+{
+	StartupTrace::markEvent(QLatin1String("firstEventLoopIteration"));
+
+	if (!StartupTrace::save())
+	{
+		Console::addMessage(tr("Failed to save startup trace"), OtherMessageCategory, ErrorMessageLevel, m_commandLineParser.value(QLatin1String("startup-trace")));
+	}
+}
+
 void Application::periodicUpdateCheck()
 {
 	UpdateChecker *updateChecker(new UpdateChecker(this));
@@ -719,6 +820,13 @@ MainWindow* Application::createWindow(MainWindowFlags flags, bool inBackground,
 
 	window->show();
 
+	if (m_windows.count() == 1 && StartupTrace::isEnabled())
+	{
+		StartupTrace::markEvent(QLatin1String("firstWindowShown"));
+
+		QTimer::singleShot(0, this, SLOT(saveStartupTrace()));
+	}
+
 	if (inBackground)
 	{
 		window->lower();
@@ -877,6 +985,7 @@ QString Application::createReport()
 	stream << QLatin1String("\n\n");
 	stream << SettingsManager::getReport();
 	stream << ActionsManager::getReport();
+	stream << HostResolver::getReport();
 
 	return report.remove(QRegularExpression(QLatin1String(" +$"), QRegularExpression::MultilineOption));
 }
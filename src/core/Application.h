@@ -28,6 +28,7 @@
 #include <QtCore/QUrl>
 #include <QtWidgets/QApplication>
 #include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
 
 namespace Otter
 {
@@ -83,7 +84,10 @@ protected slots:
 	void openUrl(const QUrl &url);
 	void updateCheckFinished(const QList<UpdateInformation> &availableUpdates);
 	void newConnection();
+	void readConnection(QLocalSocket *socket = NULL);
+	void processArguments();
 	void clearHistory();
+	void saveStartupTrace();
 	void periodicUpdateCheck();
 	void showUpdateDetails();
 
@@ -96,7 +100,9 @@ private:
 	QString m_localePath;
 	QCommandLineParser m_commandLineParser;
 	QList<MainWindow*> m_windows;
+	QList<QStringList> m_pendingArguments;
 	bool m_isHidden;
+	bool m_isProcessingScheduled;
 	bool m_isUpdating;
 
 	static Application *m_instance;
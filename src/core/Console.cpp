@@ -19,13 +19,22 @@
 
 #include "Console.h"
 
+#include <QtCore/QTimerEvent>
+
+#define CONSOLE_BUFFER_SIZE 1000
+#define CONSOLE_FLUSH_INTERVAL 16
+
 namespace Otter
 {
 
 Console* Console::m_instance = NULL;
-QList<ConsoleMessage> Console::m_messages;
+QVector<ConsoleMessage> Console::m_messages(CONSOLE_BUFFER_SIZE);
+QAtomicPointer<Console::PendingMessage> Console::m_pendingMessages(NULL);
+QAtomicInt Console::m_messagesAmounts[4];
+quint64 Console::m_sequence = 0;
 
-Console::Console(QObject *parent) : QObject(parent)
+Console::Console(QObject *parent) : QObject(parent),
+	m_flushTimer(0)
 {
 }
 
@@ -34,38 +43,132 @@ void Console::createInstance(QObject *parent)
 	if (!m_instance)
 	{
 		m_instance = new Console(parent);
+
+		if (m_pendingMessages.loadAcquire())
+		{
+			m_instance->scheduleFlush();
+		}
+	}
+}
+
+void Console::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_flushTimer)
+	{
+		killTimer(m_flushTimer);
+
+		m_flushTimer = 0;
+
+		flushMessages();
 	}
 }
 
 void Console::addMessage(const QString &note, MessageCategory category, MessageLevel level, const QString &source, int line, quint64 window)
 {
-	ConsoleMessage message;
-	message.time = QDateTime::currentDateTime();
-	message.note = note;
-	message.source = source;
-	message.category = category;
-	message.level = level;
-	message.line = line;
-	message.window = window;
-
-	m_messages.append(message);
-
-	if (m_messages.count() > 1000)
+	PendingMessage *pendingMessage(new PendingMessage());
+	pendingMessage->message.time = QDateTime::currentDateTime();
+	pendingMessage->message.note = note;
+	pendingMessage->message.source = source;
+	pendingMessage->message.category = category;
+	pendingMessage->message.level = level;
+	pendingMessage->message.line = line;
+	pendingMessage->message.window = window;
+
+	if (category >= OtherMessageCategory && category <= JavaScriptMessageCategory)
+	{
+		m_messagesAmounts[category].ref();
+	}
+
+	PendingMessage *head(m_pendingMessages.loadAcquire());
+
+	do
 	{
-		m_messages.removeFirst();
+		pendingMessage->next = head;
 	}
+	while (!m_pendingMessages.testAndSetOrdered(head, pendingMessage, head));
 
-	emit m_instance->messageAdded(message);
+	if (!head && m_instance)
+	{
+		QMetaObject::invokeMethod(m_instance, "scheduleFlush", Qt::QueuedConnection);
+	}
+}
+
+void Console::scheduleFlush()
+{
+	if (m_flushTimer == 0)
+	{
+		m_flushTimer = startTimer(CONSOLE_FLUSH_INTERVAL);
+	}
 }
 
-Console *Console::getInstance()
+void Console::flushMessages()
+{
+	PendingMessage *pendingMessage(m_pendingMessages.fetchAndStoreAcquire(NULL));
+	PendingMessage *reversedMessage(NULL);
+
+	if (!pendingMessage)
+	{
+		return;
+	}
+
+	while (pendingMessage)
+	{
+		PendingMessage *next(pendingMessage->next);
+
+		pendingMessage->next = reversedMessage;
+		reversedMessage = pendingMessage;
+		pendingMessage = next;
+	}
+
+	while (reversedMessage)
+	{
+		PendingMessage *next(reversedMessage->next);
+
+		m_messages[m_sequence % CONSOLE_BUFFER_SIZE] = reversedMessage->message;
+
+		++m_sequence;
+
+		delete reversedMessage;
+
+		reversedMessage = next;
+	}
+
+	emit messagesAdded();
+}
+
+Console* Console::getInstance()
 {
 	return m_instance;
 }
 
-QList<ConsoleMessage> Console::getMessages()
+ConsoleMessage Console::getMessage(quint64 sequence)
 {
-	return m_messages;
+	if (sequence < getFirstSequence() || sequence >= m_sequence)
+	{
+		return ConsoleMessage();
+	}
+
+	return m_messages.at(sequence % CONSOLE_BUFFER_SIZE);
+}
+
+quint64 Console::getFirstSequence()
+{
+	return ((m_sequence > CONSOLE_BUFFER_SIZE) ? (m_sequence - CONSOLE_BUFFER_SIZE) : 0);
+}
+
+quint64 Console::getLastSequence()
+{
+	return m_sequence;
+}
+
+int Console::getMessagesAmount(MessageCategory category)
+{
+	if (category < OtherMessageCategory || category > JavaScriptMessageCategory)
+	{
+		return 0;
+	}
+
+	return m_messagesAmounts[category].load();
 }
 
 }
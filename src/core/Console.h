@@ -20,8 +20,11 @@
 #ifndef OTTER_CONSOLE_H
 #define OTTER_CONSOLE_H
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QAtomicPointer>
 #include <QtCore/QDateTime>
 #include <QtCore/QObject>
+#include <QtCore/QVector>
 
 namespace Otter
 {
@@ -63,17 +66,39 @@ public:
 	static void createInstance(QObject *parent = NULL);
 	static void addMessage(const QString &note, MessageCategory category, MessageLevel level, const QString &source = QString(), int line = -1, quint64 window = 0);
 	static Console* getInstance();
-	static QList<ConsoleMessage> getMessages();
+	static ConsoleMessage getMessage(quint64 sequence);
+	static quint64 getFirstSequence();
+	static quint64 getLastSequence();
+	static int getMessagesAmount(MessageCategory category);
 
 protected:
+	struct PendingMessage
+	{
+		ConsoleMessage message;
+		PendingMessage *next;
+
+		PendingMessage() : next(NULL) {}
+	};
+
 	explicit Console(QObject *parent = NULL);
 
+	void timerEvent(QTimerEvent *event);
+
+protected slots:
+	void scheduleFlush();
+	void flushMessages();
+
 private:
+	int m_flushTimer;
+
 	static Console *m_instance;
-	static QList<ConsoleMessage> m_messages;
+	static QVector<ConsoleMessage> m_messages;
+	static QAtomicPointer<PendingMessage> m_pendingMessages;
+	static QAtomicInt m_messagesAmounts[4];
+	static quint64 m_sequence;
 
 signals:
-	void messageAdded(const ConsoleMessage &message);
+	void messagesAdded();
 };
 
 }
@@ -0,0 +1,226 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2016 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "ContentBlockingBenchmark.h"
+#include "ContentBlockingManager.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+
+namespace Otter
+{
+
+QString ContentBlockingBenchmark::createReport(const QString &path)
+{
+	QString report;
+	QTextStream stream(&report);
+	stream << QLatin1String("Content blocking benchmark:\n");
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		stream << QLatin1String("\tFailed to open corpus file: ") << path << QLatin1Char('\n');
+
+		return report;
+	}
+
+	QHash<QString, NetworkManager::ResourceType> resourceTypes;
+	resourceTypes[QLatin1String("other")] = NetworkManager::OtherType;
+	resourceTypes[QLatin1String("mainFrame")] = NetworkManager::MainFrameType;
+	resourceTypes[QLatin1String("subFrame")] = NetworkManager::SubFrameType;
+	resourceTypes[QLatin1String("styleSheet")] = NetworkManager::StyleSheetType;
+	resourceTypes[QLatin1String("script")] = NetworkManager::ScriptType;
+	resourceTypes[QLatin1String("image")] = NetworkManager::ImageType;
+	resourceTypes[QLatin1String("object")] = NetworkManager::ObjectType;
+	resourceTypes[QLatin1String("objectSubrequest")] = NetworkManager::ObjectSubrequestType;
+	resourceTypes[QLatin1String("xmlHttpRequest")] = NetworkManager::XmlHttpRequestType;
+
+	const QVector<ContentBlockingInformation> availableProfiles(ContentBlockingManager::getProfiles());
+	QVector<int> profiles;
+	QStringList failedProfiles;
+
+	stream << QLatin1String("\tProfiles:\n");
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for (int i = 0; i < availableProfiles.count(); ++i)
+	{
+		ContentBlockingManager::checkUrl(QVector<int>({i}), QUrl(), QUrl(QLatin1String("http://localhost/")), NetworkManager::OtherType);
+
+		if (!ContentBlockingManager::isProfileLoaded(i))
+		{
+			failedProfiles.append(availableProfiles.at(i).name);
+
+			continue;
+		}
+
+		profiles.append(i);
+
+		stream << QLatin1String("\t\t") << availableProfiles.at(i).name << QLatin1Char('\n');
+	}
+
+	const qint64 loadTime(timer.nsecsElapsed());
+
+	if (!failedProfiles.isEmpty())
+	{
+		stream << QLatin1String("\tFailed to load profiles:\n");
+
+		for (int i = 0; i < failedProfiles.count(); ++i)
+		{
+			stream << QLatin1String("\t\t") << failedProfiles.at(i) << QLatin1Char('\n');
+		}
+	}
+
+	if (profiles.isEmpty())
+	{
+		stream << QLatin1String("\tNo profiles loaded, aborting\n");
+
+		return report;
+	}
+
+	ContentBlockingManager::resetStatistics();
+
+	QTextStream corpus(&file);
+	QStringList mismatches;
+	QStringList invalidVerdicts;
+	QVector<qint64> latencies;
+	qint64 totalTime(0);
+	qint64 classificationTime(0);
+	int classifiedRequests(0);
+	int matchedClassifications(0);
+	int lineNumber(0);
+	int skippedLines(0);
+
+	while (!corpus.atEnd())
+	{
+		const QString line(corpus.readLine());
+
+		++lineNumber;
+
+		if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+		{
+			continue;
+		}
+
+		const QStringList fields(line.split(QLatin1Char('\t')));
+
+		if (fields.count() < 3 || !resourceTypes.contains(fields.at(2)))
+		{
+			++skippedLines;
+
+			continue;
+		}
+
+		const QString verdict((fields.count() > 3) ? fields.at(3) : QString());
+
+		if (!verdict.isEmpty() && verdict != QLatin1String("blocked") && verdict != QLatin1String("allowed"))
+		{
+			invalidVerdicts.append(QStringLiteral("%1: %2").arg(lineNumber).arg(verdict));
+
+			continue;
+		}
+
+		const QUrl baseUrl(fields.at(0));
+		const QUrl requestUrl(fields.at(1));
+		const NetworkManager::ResourceType resourceType(resourceTypes[fields.at(2)]);
+
+		timer.restart();
+
+		const NetworkManager::ResourceType classifiedType(NetworkManager::getResourceType(requestUrl));
+
+		classificationTime += timer.nsecsElapsed();
+
+		if (resourceType != NetworkManager::OtherType)
+		{
+			++classifiedRequests;
+
+			if (classifiedType == resourceType)
+			{
+				++matchedClassifications;
+			}
+		}
+
+		timer.restart();
+
+		const ContentBlockingManager::CheckResult result(ContentBlockingManager::checkUrl(profiles, baseUrl, requestUrl, resourceType));
+		const qint64 time(timer.nsecsElapsed());
+
+		totalTime += time;
+
+		latencies.append(time);
+
+		if (!verdict.isEmpty() && (verdict == QLatin1String("blocked")) != result.isBlocked)
+		{
+			mismatches.append(QStringLiteral("%1: expected %2, got %3 (%4)").arg(lineNumber).arg(verdict).arg(result.isBlocked ? QLatin1String("blocked") : QLatin1String("allowed")).arg(result.isBlocked ? (result.profile + QLatin1Char(':') + result.rule) : requestUrl.toString()));
+		}
+	}
+
+	file.close();
+
+	qSort(latencies);
+
+	const QVector<ContentBlockingManager::ProfileStatistics> statistics(ContentBlockingManager::getStatistics());
+
+	stream.setRealNumberNotation(QTextStream::FixedNotation);
+	stream.setRealNumberPrecision(2);
+	stream << QLatin1String("\tLoad time: ") << (loadTime / 1000000.0) << QLatin1String(" ms\n");
+	stream << QLatin1String("\tRequests: ") << latencies.count() << QLatin1Char('\n');
+	stream << QLatin1String("\tSkipped lines: ") << skippedLines << QLatin1Char('\n');
+	stream << QLatin1String("\tRequests per second: ") << ((totalTime > 0) ? (latencies.count() * 1000000000.0 / totalTime) : 0.0) << QLatin1Char('\n');
+	stream << QLatin1String("\tLatency p50: ") << (latencies.value((latencies.count() / 2), 0) / 1000.0) << QLatin1String(" us\n");
+	stream << QLatin1String("\tLatency p99: ") << (latencies.value(((latencies.count() * 99) / 100), 0) / 1000.0) << QLatin1String(" us\n");
+	stream << QLatin1String("\tClassification time: ") << (latencies.isEmpty() ? 0.0 : (classificationTime / 1000.0 / latencies.count())) << QLatin1String(" us per request\n");
+	stream << QLatin1String("\tClassification matches: ") << matchedClassifications << QLatin1Char('/') << classifiedRequests << QLatin1Char('\n');
+	stream << QLatin1String("\tPer profile:\n");
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		if (profiles.at(i) >= statistics.count())
+		{
+			continue;
+		}
+
+		const ContentBlockingManager::ProfileStatistics &profileStatistics(statistics.at(profiles.at(i)));
+
+		stream << QLatin1String("\t\t") << availableProfiles.at(profiles.at(i)).name << QLatin1String(": ") << profileStatistics.requests << QLatin1String(" requests, ") << profileStatistics.blockedRequests << QLatin1String(" blocked, ") << ((profileStatistics.requests > 0) ? (static_cast<double>(profileStatistics.evaluatedRules) / profileStatistics.requests) : 0.0) << QLatin1String(" rules per request\n");
+	}
+
+	stream << QLatin1String("\tInvalid verdicts: ") << invalidVerdicts.count() << QLatin1Char('\n');
+
+	for (int i = 0; i < invalidVerdicts.count(); ++i)
+	{
+		stream << QLatin1String("\t\t") << invalidVerdicts.at(i) << QLatin1Char('\n');
+	}
+
+	stream << QLatin1String("\tVerdict mismatches: ") << mismatches.count() << QLatin1Char('\n');
+
+	for (int i = 0; i < mismatches.count(); ++i)
+	{
+		stream << QLatin1String("\t\t") << mismatches.at(i) << QLatin1Char('\n');
+	}
+
+	stream.flush();
+
+	return report;
+}
+
+}
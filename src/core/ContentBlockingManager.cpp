@@ -25,22 +25,36 @@
 #include "SessionsManager.h"
 
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#define CONTENTBLOCKING_STYLESHEETS_CACHE_SIZE 100
 
 namespace Otter
 {
 
 ContentBlockingManager* ContentBlockingManager::m_instance = NULL;
 QVector<ContentBlockingProfile*> ContentBlockingManager::m_profiles;
+QHash<QString, QString> ContentBlockingManager::m_genericStyleSheets;
+QHash<QString, QString> ContentBlockingManager::m_styleSheets;
+QVector<ContentBlockingManager::ProfileCounters*> ContentBlockingManager::m_statistics;
+QMutex ContentBlockingManager::m_statisticsMutex;
+QVector<int> ContentBlockingManager::m_latencyBuckets({10, 50, 100, 500, 1000, 5000, 10000});
+bool ContentBlockingManager::m_canUpdate = true;
 
 ContentBlockingManager::ContentBlockingManager(QObject *parent) : QObject(parent)
 {
+	connect(this, SIGNAL(profileModified(QString)), this, SLOT(clearStyleSheets()));
 }
 
-void ContentBlockingManager::createInstance(QObject *parent)
+void ContentBlockingManager::createInstance(QObject *parent, bool canUpdate)
 {
 	if (!m_instance)
 	{
 		m_instance = new ContentBlockingManager(parent);
+		m_canUpdate = canUpdate;
 
 		loadProfiles();
 	}
@@ -51,34 +65,50 @@ void ContentBlockingManager::loadProfiles()
 	const QString contentBlockingPath(SessionsManager::getWritableDataPath(QLatin1String("blocking")));
 	const QDir directory(contentBlockingPath);
 
-	if (!directory.exists())
+	if (m_canUpdate && !directory.exists())
 	{
 		QDir().mkpath(contentBlockingPath);
 	}
 
 	const QList<QFileInfo> availableProfiles(QDir(QLatin1String(":/blocking/")).entryInfoList(QStringList(QLatin1String("*.txt")), QDir::Files));
+	QList<QFileInfo> bundledProfiles;
 
 	for (int i = 0; i < availableProfiles.count(); ++i)
 	{
 		const QString path(directory.filePath(availableProfiles.at(i).fileName()));
 
-		if (!QFile::exists(path))
+		if (QFile::exists(path))
+		{
+			continue;
+		}
+
+		if (m_canUpdate)
 		{
 			QFile::copy(availableProfiles.at(i).filePath(), path);
 			QFile::setPermissions(path, (QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ReadGroup | QFileDevice::ReadOther));
 		}
+		else
+		{
+			bundledProfiles.append(availableProfiles.at(i));
+		}
 	}
 
-	const QList<QFileInfo> existingProfiles(directory.entryInfoList(QStringList(QLatin1String("*.txt")), QDir::Files));
+	const QList<QFileInfo> existingProfiles(directory.entryInfoList(QStringList(QLatin1String("*.txt")), QDir::Files) + bundledProfiles);
 
 	for (int i = 0; i < existingProfiles.count(); ++i)
 	{
-		ContentBlockingProfile *profile(new ContentBlockingProfile(existingProfiles.at(i).absoluteFilePath(), m_instance));
+		ContentBlockingProfile *profile(new ContentBlockingProfile(existingProfiles.at(i).absoluteFilePath(), m_instance, m_canUpdate));
+
+		ProfileCounters *statistics(new ProfileCounters());
+		statistics->latencyHistogram.resize(m_latencyBuckets.count() + 1);
 
 		m_profiles.append(profile);
+		m_statistics.append(statistics);
 
 		connect(profile, SIGNAL(profileModified(QString)), m_instance, SIGNAL(profileModified(QString)));
 	}
+
+	resetStatistics();
 }
 
 ContentBlockingManager* ContentBlockingManager::getInstance()
@@ -100,11 +130,44 @@ ContentBlockingManager::CheckResult ContentBlockingManager::checkUrl(const QVect
 		return CheckResult();
 	}
 
+	if (resourceType == NetworkManager::OtherType)
+	{
+		resourceType = NetworkManager::getResourceType(requestUrl);
+	}
+
 	for (int i = 0; i < profiles.count(); ++i)
 	{
 		if (profiles[i] >= 0 && profiles[i] < m_profiles.count())
 		{
+			QElapsedTimer timer;
+			timer.start();
+
 			const CheckResult currentResult(m_profiles.at(profiles[i])->checkUrl(baseUrl, requestUrl, resourceType));
+			const qint64 time(timer.nsecsElapsed());
+			int bucket(0);
+
+			while (bucket < m_latencyBuckets.count() && time >= (m_latencyBuckets.at(bucket) * 1000))
+			{
+				++bucket;
+			}
+
+			if (profiles[i] < m_statistics.count())
+			{
+				ProfileCounters *statistics(m_statistics.at(profiles[i]));
+				statistics->latencyHistogram[bucket].ref();
+				statistics->requests.ref();
+				statistics->totalTime.fetchAndAddRelaxed(time);
+				statistics->evaluatedRules.fetchAndAddRelaxed(currentResult.evaluatedRules);
+
+				if (currentResult.isBlocked)
+				{
+					statistics->blockedRequests.ref();
+
+					QMutexLocker locker(&m_statisticsMutex);
+
+					++statistics->ruleHits[currentResult.rule];
+				}
+			}
 
 			if (currentResult.isBlocked)
 			{
@@ -116,6 +179,76 @@ ContentBlockingManager::CheckResult ContentBlockingManager::checkUrl(const QVect
 	return CheckResult();
 }
 
+void ContentBlockingManager::resetStatistics()
+{
+	for (int i = 0; i < m_statistics.count(); ++i)
+	{
+		ProfileCounters *statistics(m_statistics.at(i));
+
+		for (int j = 0; j < statistics->latencyHistogram.count(); ++j)
+		{
+			statistics->latencyHistogram[j].store(0);
+		}
+
+		statistics->totalTime.store(0);
+		statistics->evaluatedRules.store(0);
+		statistics->requests.store(0);
+		statistics->blockedRequests.store(0);
+
+		QMutexLocker locker(&m_statisticsMutex);
+
+		statistics->ruleHits.clear();
+	}
+}
+
+QByteArray ContentBlockingManager::exportStatistics()
+{
+	const QVector<ProfileStatistics> statisticsList(getStatistics());
+	QJsonArray profilesArray;
+
+	for (int i = 0; i < m_profiles.count() && i < statisticsList.count(); ++i)
+	{
+		const ContentBlockingInformation information(m_profiles.at(i)->getInformation());
+		const ProfileStatistics &statistics(statisticsList.at(i));
+		QJsonArray histogramArray;
+
+		for (int j = 0; j < statistics.latencyHistogram.count(); ++j)
+		{
+			QJsonObject bucketObject;
+			bucketObject.insert(QLatin1String("upperBound"), ((j < m_latencyBuckets.count()) ? QJsonValue(m_latencyBuckets.at(j)) : QJsonValue()));
+			bucketObject.insert(QLatin1String("requests"), statistics.latencyHistogram.at(j));
+
+			histogramArray.append(bucketObject);
+		}
+
+		QJsonObject rulesObject;
+		QHash<QString, int>::const_iterator iterator;
+
+		for (iterator = statistics.ruleHits.constBegin(); iterator != statistics.ruleHits.constEnd(); ++iterator)
+		{
+			rulesObject.insert(iterator.key(), iterator.value());
+		}
+
+		QJsonObject profileObject;
+		profileObject.insert(QLatin1String("name"), information.name);
+		profileObject.insert(QLatin1String("title"), information.title);
+		profileObject.insert(QLatin1String("requests"), statistics.requests);
+		profileObject.insert(QLatin1String("blockedRequests"), statistics.blockedRequests);
+		profileObject.insert(QLatin1String("totalTime"), (statistics.totalTime / 1000.0));
+		profileObject.insert(QLatin1String("evaluatedRules"), static_cast<double>(statistics.evaluatedRules));
+		profileObject.insert(QLatin1String("latencyHistogram"), histogramArray);
+		profileObject.insert(QLatin1String("ruleHits"), rulesObject);
+
+		profilesArray.append(profileObject);
+	}
+
+	QJsonObject statisticsObject;
+	statisticsObject.insert(QLatin1String("timeUnit"), QLatin1String("us"));
+	statisticsObject.insert(QLatin1String("profiles"), profilesArray);
+
+	return QJsonDocument(statisticsObject).toJson(QJsonDocument::Indented);
+}
+
 ContentBlockingInformation ContentBlockingManager::getProfile(const QString &profile)
 {
 	for (int i = 0; i < m_profiles.count(); ++i)
@@ -147,6 +280,95 @@ QStringList ContentBlockingManager::createSubdomainList(const QString &domain)
 	return subdomainList;
 }
 
+void ContentBlockingManager::clearStyleSheets()
+{
+	m_genericStyleSheets.clear();
+	m_styleSheets.clear();
+}
+
+QString ContentBlockingManager::createElementHidingStyleSheet(const QStringList &selectors, const QSet<QString> &exceptions)
+{
+	QString styleSheet;
+	QSet<QString> addedSelectors;
+
+	for (int i = 0; i < selectors.count(); ++i)
+	{
+		const QString selector(selectors.at(i));
+
+		if (selector.isEmpty() || exceptions.contains(selector) || addedSelectors.contains(selector))
+		{
+			continue;
+		}
+
+		addedSelectors.insert(selector);
+
+		styleSheet.append(selector);
+		styleSheet.append(QLatin1String(" {display:none !important;}\n"));
+	}
+
+	return styleSheet;
+}
+
+QString ContentBlockingManager::getElementHidingStyleSheet(const QString &domain, const QVector<int> &profiles)
+{
+	if (profiles.isEmpty())
+	{
+		return QString();
+	}
+
+	QString profilesKey;
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		profilesKey.append(QString::number(profiles.at(i)));
+		profilesKey.append(QLatin1Char(','));
+	}
+
+	const QString key(profilesKey + QLatin1Char('|') + domain);
+
+	if (m_styleSheets.contains(key))
+	{
+		return m_styleSheets[key];
+	}
+
+	const QStringList domains(createSubdomainList(domain));
+	QStringList blackList;
+	QSet<QString> whiteList;
+
+	for (int i = 0; i < domains.count(); ++i)
+	{
+		blackList.append(getStyleSheetBlackList(domains.at(i), profiles));
+		whiteList.unite(getStyleSheetWhiteList(domains.at(i), profiles).toSet());
+	}
+
+	QString styleSheet;
+
+	if (whiteList.isEmpty())
+	{
+		if (!m_genericStyleSheets.contains(profilesKey))
+		{
+			m_genericStyleSheets[profilesKey] = createElementHidingStyleSheet(getStyleSheet(profiles), QSet<QString>());
+		}
+
+		styleSheet = m_genericStyleSheets[profilesKey];
+	}
+	else
+	{
+		styleSheet = createElementHidingStyleSheet(getStyleSheet(profiles), whiteList);
+	}
+
+	styleSheet.append(createElementHidingStyleSheet(blackList, whiteList));
+
+	if (m_styleSheets.count() >= CONTENTBLOCKING_STYLESHEETS_CACHE_SIZE)
+	{
+		m_styleSheets.clear();
+	}
+
+	m_styleSheets[key] = styleSheet;
+
+	return styleSheet;
+}
+
 QStringList ContentBlockingManager::getStyleSheet(const QVector<int> &profiles)
 {
 	QStringList styleSheet;
@@ -221,8 +443,51 @@ QVector<int> ContentBlockingManager::getProfileList(const QStringList &names)
 	return profiles;
 }
 
+QVector<ContentBlockingManager::ProfileStatistics> ContentBlockingManager::getStatistics()
+{
+	QVector<ProfileStatistics> statisticsList;
+	statisticsList.reserve(m_statistics.count());
+
+	for (int i = 0; i < m_statistics.count(); ++i)
+	{
+		const ProfileCounters *counters(m_statistics.at(i));
+		ProfileStatistics statistics;
+		statistics.latencyHistogram.reserve(counters->latencyHistogram.count());
+
+		for (int j = 0; j < counters->latencyHistogram.count(); ++j)
+		{
+			statistics.latencyHistogram.append(counters->latencyHistogram.at(j).load());
+		}
+
+		statistics.totalTime = counters->totalTime.load();
+		statistics.evaluatedRules = counters->evaluatedRules.load();
+		statistics.requests = counters->requests.load();
+		statistics.blockedRequests = counters->blockedRequests.load();
+
+		m_statisticsMutex.lock();
+
+		statistics.ruleHits = counters->ruleHits;
+
+		m_statisticsMutex.unlock();
+
+		statisticsList.append(statistics);
+	}
+
+	return statisticsList;
+}
+
+QVector<int> ContentBlockingManager::getLatencyBuckets()
+{
+	return m_latencyBuckets;
+}
+
 bool ContentBlockingManager::updateProfile(const QString &profile)
 {
+	if (!m_canUpdate)
+	{
+		return false;
+	}
+
 	for (int i = 0; i < m_profiles.count(); ++i)
 	{
 		if (m_profiles.at(i)->getInformation().name == profile)
@@ -234,4 +499,9 @@ bool ContentBlockingManager::updateProfile(const QString &profile)
 	return false;
 }
 
+bool ContentBlockingManager::isProfileLoaded(int profile)
+{
+	return (profile >= 0 && profile < m_profiles.count() && m_profiles.at(profile)->isLoaded());
+}
+
 }
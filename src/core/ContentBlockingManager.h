@@ -23,6 +23,9 @@
 
 #include "NetworkManager.h"
 
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
 #include <QtCore/QUrl>
 
 namespace Otter
@@ -40,32 +43,72 @@ public:
 	{
 		QUrl url;
 		QString profile;
+		QString rule;
 		NetworkManager::ResourceType resourceType;
+		int evaluatedRules;
 		bool isBlocked;
 
-		CheckResult() : resourceType(NetworkManager::OtherType), isBlocked(false) {}
+		CheckResult() : resourceType(NetworkManager::OtherType), evaluatedRules(0), isBlocked(false) {}
 	};
 
-	static void createInstance(QObject *parent = NULL);
+	struct ProfileStatistics
+	{
+		QHash<QString, int> ruleHits;
+		QVector<int> latencyHistogram;
+		qint64 totalTime;
+		qint64 evaluatedRules;
+		int requests;
+		int blockedRequests;
+
+		ProfileStatistics() : totalTime(0), evaluatedRules(0), requests(0), blockedRequests(0) {}
+	};
+
+	static void createInstance(QObject *parent = NULL, bool canUpdate = true);
 	static ContentBlockingManager* getInstance();
 	static CheckResult checkUrl(const QVector<int> &profiles, const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType);
 	static ContentBlockingInformation getProfile(const QString &profile);
 	static QStringList createSubdomainList(const QString &domain);
+	static QString getElementHidingStyleSheet(const QString &domain, const QVector<int> &profiles);
 	static QStringList getStyleSheet(const QVector<int> &profiles);
 	static QStringList getStyleSheetBlackList(const QString &domain, const QVector<int> &profiles);
 	static QStringList getStyleSheetWhiteList(const QString &domain, const QVector<int> &profiles);
 	static QVector<ContentBlockingInformation> getProfiles();
 	static QVector<int> getProfileList(const QStringList &names);
+	static QVector<ProfileStatistics> getStatistics();
+	static QVector<int> getLatencyBuckets();
+	static QByteArray exportStatistics();
+	static void resetStatistics();
 	static bool updateProfile(const QString &profile);
+	static bool isProfileLoaded(int profile);
 
 protected:
+	struct ProfileCounters
+	{
+		QHash<QString, int> ruleHits;
+		QVector<QAtomicInt> latencyHistogram;
+		QAtomicInteger<qint64> totalTime;
+		QAtomicInteger<qint64> evaluatedRules;
+		QAtomicInt requests;
+		QAtomicInt blockedRequests;
+	};
+
 	explicit ContentBlockingManager(QObject *parent = NULL);
 
 	static void loadProfiles();
+	static QString createElementHidingStyleSheet(const QStringList &selectors, const QSet<QString> &exceptions);
+
+protected slots:
+	void clearStyleSheets();
 
 private:
 	static ContentBlockingManager *m_instance;
 	static QVector<ContentBlockingProfile*> m_profiles;
+	static QHash<QString, QString> m_genericStyleSheets;
+	static QHash<QString, QString> m_styleSheets;
+	static QVector<ProfileCounters*> m_statistics;
+	static QMutex m_statisticsMutex;
+	static QVector<int> m_latencyBuckets;
+	static bool m_canUpdate;
 
 signals:
 	void profileModified(const QString &profile);
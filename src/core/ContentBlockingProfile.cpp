@@ -36,10 +36,12 @@
 namespace Otter
 {
 
-ContentBlockingProfile::ContentBlockingProfile(const QString &path, QObject *parent) : QObject(parent),
+ContentBlockingProfile::ContentBlockingProfile(const QString &path, QObject *parent, bool canUpdate) : QObject(parent),
 	m_root(NULL),
 	m_networkReply(NULL),
+	m_evaluatedRules(0),
 	m_enableWildcards(SettingsManager::getValue(QLatin1String("ContentBlocking/EnableWildcards")).toBool()),
+	m_canUpdate(canUpdate),
 	m_isUpdating(false),
 	m_isEmpty(true),
 	m_wasLoaded(false)
@@ -138,7 +140,7 @@ void ContentBlockingProfile::load(bool onlyHeader)
 	const QDateTime lastUpdate(QDateTime::fromString(profilesSettings.value(m_information.name + QLatin1String("/lastUpdate")).toString(), Qt::ISODate));
 	const int updateInterval(profilesSettings.value(m_information.name + QLatin1String("/updateInterval")).toInt());
 
-	if (!m_isUpdating && updateInterval > 0 && (!lastUpdate.isValid() || lastUpdate.daysTo(QDateTime::currentDateTime()) > updateInterval))
+	if (m_canUpdate && !m_isUpdating && updateInterval > 0 && (!lastUpdate.isValid() || lastUpdate.daysTo(QDateTime::currentDateTime()) > updateInterval))
 	{
 		downloadRules();
 	}
@@ -439,27 +441,32 @@ ContentBlockingManager::CheckResult ContentBlockingProfile::checkUrl(const QUrl
 	m_baseUrlHost = baseUrl.host();
 	m_requestUrl = requestUrl.url(QUrl::RemoveScheme);
 	m_requestHost = requestUrl.host();
+	m_evaluatedRules = 0;
 
 	if (m_requestUrl.startsWith(QLatin1String("//")))
 	{
 		m_requestUrl = m_requestUrl.mid(2);
 	}
 
+	ContentBlockingManager::CheckResult result;
+
 	for (int i = 0; i < m_requestUrl.length(); ++i)
 	{
 		if (checkUrlSubstring(m_root, m_requestUrl.right(m_requestUrl.length() - i), QString(), resourceType))
 		{
-			ContentBlockingManager::CheckResult result;
 			result.url = requestUrl;
 			result.profile = m_information.name;
+			result.rule = m_matchedRule;
 			result.resourceType = resourceType;
 			result.isBlocked = true;
 
-			return result;
+			break;
 		}
 	}
 
-	return ContentBlockingManager::CheckResult();
+	result.evaluatedRules = m_evaluatedRules;
+
+	return result;
 }
 
 QStringList ContentBlockingProfile::getStyleSheet()
@@ -529,7 +536,19 @@ bool ContentBlockingProfile::loadRules()
 {
 	if (m_isEmpty)
 	{
-		downloadRules();
+		if (m_canUpdate)
+		{
+			downloadRules();
+		}
+
+		return false;
+	}
+
+	QFile file(m_information.path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to open content blocking profile file: %1").arg(file.errorString()), Otter::OtherMessageCategory, ErrorMessageLevel, m_information.path);
 
 		return false;
 	}
@@ -544,9 +563,6 @@ bool ContentBlockingProfile::loadRules()
 #endif
 	}
 
-	QFile file(m_information.path);
-	file.open(QIODevice::ReadOnly | QIODevice::Text);
-
 	QTextStream stream(&file);
 	stream.readLine(); // header
 
@@ -633,6 +649,8 @@ bool ContentBlockingProfile::checkUrlSubstring(Node *node, const QString &subStr
 
 bool ContentBlockingProfile::checkRuleMatch(ContentBlockingRule *rule, const QString &currentRule, NetworkManager::ResourceType resourceType)
 {
+	++m_evaluatedRules;
+
 	if (!m_requestUrl.contains(currentRule))
 	{
 		return false;
@@ -679,7 +697,19 @@ bool ContentBlockingProfile::checkRuleMatch(ContentBlockingRule *rule, const QSt
 		}
 	}
 
-	return (isBlocked ? !rule->isException : false);
+	if (isBlocked && !rule->isException)
+	{
+		m_matchedRule = currentRule;
+
+		return true;
+	}
+
+	return false;
+}
+
+bool ContentBlockingProfile::isLoaded() const
+{
+	return m_wasLoaded;
 }
 
 }
@@ -67,7 +67,7 @@ public:
 		bool needsDomainCheck;
 	};
 
-	explicit ContentBlockingProfile(const QString &path, QObject *parent = NULL);
+	explicit ContentBlockingProfile(const QString &path, QObject *parent = NULL, bool canUpdate = true);
 
 	ContentBlockingInformation getInformation() const;
 	ContentBlockingManager::CheckResult checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType);
@@ -75,6 +75,7 @@ public:
 	QStringList getStyleSheetBlackList(const QString &domain);
 	QStringList getStyleSheetWhiteList(const QString &domain);
 	bool downloadRules();
+	bool isLoaded() const;
 
 protected:
 	struct Node
@@ -107,12 +108,15 @@ private:
 	QString m_requestUrl;
 	QString m_requestHost;
 	QString m_baseUrlHost;
+	QString m_matchedRule;
 	QRegularExpression m_domainExpression;
 	ContentBlockingInformation m_information;
 	QStringList m_styleSheet;
 	QMultiHash<QString, QString> m_styleSheetBlackList;
 	QMultiHash<QString, QString> m_styleSheetWhiteList;
+	int m_evaluatedRules;
 	bool m_enableWildcards;
+	bool m_canUpdate;
 	bool m_isUpdating;
 	bool m_isEmpty;
 	bool m_wasLoaded;
@@ -157,8 +157,7 @@ void GesturesManager::createInstance(QObject *parent)
 		m_nativeGestures[GesturesManager::TabHandleGesturesContext] = tabHandle;
 
 		m_instance = new GesturesManager(parent);
-
-		loadProfiles();
+		m_instance->m_reloadTimer = m_instance->startTimer(0);
 	}
 }
 
@@ -627,6 +626,14 @@ bool GesturesManager::startGesture(QObject *object, QEvent *event, QList<Gesture
 {
 	QInputEvent *inputEvent(static_cast<QInputEvent*>(event));
 
+	if (m_instance && m_instance->m_reloadTimer != 0)
+	{
+		m_instance->killTimer(m_instance->m_reloadTimer);
+		m_instance->m_reloadTimer = 0;
+
+		loadProfiles();
+	}
+
 	if (!object || !inputEvent || m_gestures.keys().toSet().intersect(contexts.toSet()).isEmpty() || m_events.contains(inputEvent))
 	{
 		return false;
@@ -28,9 +28,14 @@ namespace Otter
 {
 
 HandlersManager* HandlersManager::m_instance = NULL;
+QHash<QString, HandlerDefinition> HandlersManager::m_handlers;
+bool HandlersManager::m_isLoaded = false;
 
-HandlersManager::HandlersManager(QObject *parent) : QObject(parent)
+HandlersManager::HandlersManager(QObject *parent) : QObject(parent),
+	m_fileSystemWatcher(new QFileSystemWatcher(this))
 {
+	connect(m_fileSystemWatcher, SIGNAL(fileChanged(QString)), this, SLOT(clearHandlers()));
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString)));
 }
 
 void HandlersManager::createInstance(QObject *parent)
@@ -41,54 +46,113 @@ void HandlersManager::createInstance(QObject *parent)
 	}
 }
 
-HandlersManager* HandlersManager::getInstance()
+void HandlersManager::optionChanged(const QString &option)
 {
-	return m_instance;
+	if (option == QLatin1String("Paths/Downloads"))
+	{
+		clearHandlers();
+	}
 }
 
-HandlerDefinition HandlersManager::getHandler(const QString &type)
+void HandlersManager::clearHandlers()
+{
+	m_handlers.clear();
+
+	m_isLoaded = false;
+}
+
+void HandlersManager::loadHandlers()
 {
-	Settings settings(SessionsManager::getReadableDataPath(QLatin1String("handlers.ini")));
-	HandlerDefinition definition;
-	definition.isExplicit = settings.getGroups().contains(type);
+	const QString path(SessionsManager::getReadableDataPath(QLatin1String("handlers.ini")));
+	const QString defaultDownloadsPath(SettingsManager::getValue(QLatin1String("Paths/Downloads")).toString());
+	Settings settings(path);
+	const QStringList types(settings.getGroups());
 
-	if (definition.isExplicit)
+	m_handlers.clear();
+
+	for (int i = 0; i < types.count(); ++i)
 	{
-		settings.beginGroup(type);
+		settings.beginGroup(types.at(i));
+
+		const QString downloadsPath(settings.getValue(QLatin1String("downloadsPath"), QString()).toString());
+		const QString transferMode(settings.getValue(QLatin1String("transferMode"), QString()).toString());
+		HandlerDefinition definition;
+		definition.openCommand = settings.getValue(QLatin1String("openCommand"), QString()).toString();
+		definition.downloadsPath = (downloadsPath.isEmpty() ? defaultDownloadsPath : downloadsPath);
+
+		if (transferMode == QLatin1String("ignore"))
+		{
+			definition.transferMode = IgnoreTransferMode;
+		}
+		else if (transferMode == QLatin1String("open"))
+		{
+			definition.transferMode = OpenTransferMode;
+		}
+		else if (transferMode == QLatin1String("save"))
+		{
+			definition.transferMode = SaveTransferMode;
+		}
+		else if (transferMode == QLatin1String("saveAs"))
+		{
+			definition.transferMode = SaveAsTransferMode;
+		}
+		else
+		{
+			definition.transferMode = AskTransferMode;
+		}
+
+		m_handlers[types.at(i)] = definition;
+
+		settings.endGroup();
 	}
-	else
+
+	if (m_handlers.contains(QLatin1String("*")))
 	{
-		settings.beginGroup(QLatin1String("*"));
+		m_handlers[QLatin1String("*")].isExplicit = false;
 	}
-
-	const QString downloadsPath(settings.getValue(QLatin1String("downloadsPath"), QString()).toString());
-	const QString transferMode(settings.getValue(QLatin1String("transferMode"), QString()).toString());
-
-	definition.openCommand = settings.getValue(QLatin1String("openCommand"), QString()).toString();
-	definition.downloadsPath = (downloadsPath.isEmpty() ? SettingsManager::getValue(QLatin1String("Paths/Downloads")).toString() : downloadsPath);
-
-	if (transferMode == QLatin1String("ignore"))
+	else
 	{
-		definition.transferMode = IgnoreTransferMode;
+		HandlerDefinition definition;
+		definition.downloadsPath = defaultDownloadsPath;
+		definition.transferMode = AskTransferMode;
+		definition.isExplicit = false;
+
+		m_handlers[QLatin1String("*")] = definition;
 	}
-	else if (transferMode == QLatin1String("open"))
+
+	if (m_instance && !path.startsWith(QLatin1Char(':')) && !m_instance->m_fileSystemWatcher->files().contains(path))
 	{
-		definition.transferMode = OpenTransferMode;
+		m_instance->m_fileSystemWatcher->addPath(path);
 	}
-	else if (transferMode == QLatin1String("save"))
+
+	m_isLoaded = true;
+}
+
+HandlersManager* HandlersManager::getInstance()
+{
+	return m_instance;
+}
+
+HandlerDefinition HandlersManager::getHandler(const QString &type)
+{
+	if (!m_isLoaded)
 	{
-		definition.transferMode = SaveTransferMode;
+		loadHandlers();
 	}
-	else if (transferMode == QLatin1String("saveAs"))
+
+	if (m_handlers.contains(type))
 	{
-		definition.transferMode = SaveAsTransferMode;
+		return m_handlers[type];
 	}
-	else
+
+	const QString family(type.section(QLatin1Char('/'), 0, 0) + QLatin1String("/*"));
+
+	if (m_handlers.contains(family))
 	{
-		definition.transferMode = AskTransferMode;
+		return m_handlers[family];
 	}
 
-	return definition;
+	return m_handlers[QLatin1String("*")];
 }
 
 void HandlersManager::setHandler(const QString &type, const HandlerDefinition &definition)
@@ -124,6 +188,10 @@ void HandlersManager::setHandler(const QString &type, const HandlerDefinition &d
 	settings.setValue(QLatin1String("downloadsPath"), definition.downloadsPath);
 	settings.setValue(QLatin1String("transferMode"), transferMode);
 	settings.save(path);
+
+	m_handlers.clear();
+
+	m_isLoaded = false;
 }
 
 }
@@ -20,7 +20,8 @@
 #ifndef OTTER_HANDLERSMANAGER_H
 #define OTTER_HANDLERSMANAGER_H
 
-#include <QtCore/QObject>
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QHash>
 
 namespace Otter
 {
@@ -57,8 +58,18 @@ public:
 protected:
 	explicit HandlersManager(QObject *parent = NULL);
 
+	static void loadHandlers();
+
+protected slots:
+	void optionChanged(const QString &option);
+	void clearHandlers();
+
 private:
+	QFileSystemWatcher *m_fileSystemWatcher;
+
 	static HandlersManager *m_instance;
+	static QHash<QString, HandlerDefinition> m_handlers;
+	static bool m_isLoaded;
 };
 
 }
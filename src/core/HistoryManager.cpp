@@ -399,4 +399,9 @@ bool HistoryManager::hasEntry(const QUrl &url)
 	return m_browsingHistoryModel->hasEntry(url);
 }
 
+bool HistoryManager::isEnabled()
+{
+	return m_isEnabled;
+}
+
 }
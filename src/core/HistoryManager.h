@@ -47,6 +47,7 @@ public:
 	static QList<HistoryModel::HistoryEntryMatch> findEntries(const QString &prefix);
 	static quint64 addEntry(const QUrl &url, const QString &title, const QIcon &icon, bool isTypedIn = false);
 	static bool hasEntry(const QUrl &url);
+	static bool isEnabled();
 
 protected:
 	explicit HistoryManager(QObject *parent = NULL);
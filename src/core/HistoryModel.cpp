@@ -93,6 +93,8 @@ void HistoryModel::clearRecentEntries(uint period)
 {
 	if (period == 0)
 	{
+		m_days.clear();
+
 		clear();
 
 		emit cleared();
@@ -153,6 +155,18 @@ void HistoryModel::removeEntry(quint64 identifier)
 		m_identifiers.remove(identifier);
 	}
 
+	const QDate date(entry->data(TimeVisitedRole).toDateTime().date());
+
+	if (m_days.contains(date))
+	{
+		m_days[date].removeAll(entry);
+
+		if (m_days[date].isEmpty())
+		{
+			m_days.remove(date);
+		}
+	}
+
 	emit entryRemoved(entry);
 
 	removeRow(entry->row());
@@ -198,6 +212,21 @@ HistoryEntryItem* HistoryModel::getEntry(quint64 identifier) const
 	return NULL;
 }
 
+QList<HistoryEntryItem*> HistoryModel::getEntries(const QDate &from, const QDate &to) const
+{
+	QList<HistoryEntryItem*> entries;
+	QMap<QDate, QList<HistoryEntryItem*> >::const_iterator iterator(from.isValid() ? m_days.lowerBound(from) : m_days.constBegin());
+
+	while (iterator != m_days.constEnd() && (!to.isValid() || iterator.key() < to))
+	{
+		entries.append(iterator.value());
+
+		++iterator;
+	}
+
+	return entries;
+}
+
 QList<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn) const
 {
 	QList<HistoryEntryItem*> matchedEntries;
@@ -318,6 +347,27 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 		}
 	}
 
+	if (role == TimeVisitedRole)
+	{
+		const QDate oldDate(index.data(TimeVisitedRole).toDateTime().date());
+		const QDate newDate(value.toDateTime().date());
+
+		if (oldDate != newDate || index.data(TimeVisitedRole).isNull())
+		{
+			if (m_days.contains(oldDate))
+			{
+				m_days[oldDate].removeAll(entry);
+
+				if (m_days[oldDate].isEmpty())
+				{
+					m_days.remove(oldDate);
+				}
+			}
+
+			m_days[newDate].append(entry);
+		}
+	}
+
 	entry->setItemData(value, role);
 
 	switch (role)
@@ -335,6 +385,21 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 	return true;
 }
 
+int HistoryModel::getEntriesAmount(const QDate &from, const QDate &to) const
+{
+	int amount(0);
+	QMap<QDate, QList<HistoryEntryItem*> >::const_iterator iterator(from.isValid() ? m_days.lowerBound(from) : m_days.constBegin());
+
+	while (iterator != m_days.constEnd() && (!to.isValid() || iterator.key() < to))
+	{
+		amount += iterator.value().count();
+
+		++iterator;
+	}
+
+	return amount;
+}
+
 bool HistoryModel::hasEntry(const QUrl &url) const
 {
 	return m_urls.contains(url);
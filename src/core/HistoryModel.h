@@ -69,7 +69,9 @@ public:
 	void removeEntry(quint64 identifier);
 	HistoryEntryItem* addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date = QDateTime::currentDateTime(), quint64 identifier = 0);
 	HistoryEntryItem* getEntry(quint64 identifier) const;
+	QList<HistoryEntryItem*> getEntries(const QDate &from, const QDate &to) const;
 	QList<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false) const;
+	int getEntriesAmount(const QDate &from, const QDate &to) const;
 	bool hasEntry(const QUrl &url) const;
 	bool save(const QString &path) const;
 	bool setData(const QModelIndex &index, const QVariant &value, int role);
@@ -77,6 +79,7 @@ public:
 private:
 	QHash<QUrl, QList<HistoryEntryItem*> > m_urls;
 	QMap<quint64, HistoryEntryItem*> m_identifiers;
+	QMap<QDate, QList<HistoryEntryItem*> > m_days;
 
 signals:
 	void cleared();
@@ -0,0 +1,185 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2016 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HostResolver.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QTextStream>
+
+#define HOSTRESOLVER_CACHE_SIZE 1000
+#define HOSTRESOLVER_NEGATIVE_TTL 60000
+#define HOSTRESOLVER_POSITIVE_TTL 300000
+
+namespace Otter
+{
+
+HostResolver* HostResolver::m_instance = NULL;
+QHash<QString, HostResolver::HostEntry> HostResolver::m_hosts;
+QHash<int, QString> HostResolver::m_lookups;
+HostResolver::ResolverStatistics HostResolver::m_statistics;
+
+HostResolver::HostResolver(QObject *parent) : QObject(parent)
+{
+}
+
+void HostResolver::handleLookup(const QHostInfo &information)
+{
+	const QString host(m_lookups.take(information.lookupId()));
+
+	if (host.isEmpty() || !m_hosts.contains(host))
+	{
+		return;
+	}
+
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+	const bool isResolved(information.error() == QHostInfo::NoError);
+	HostEntry &entry(m_hosts[host]);
+	entry.status = (isResolved ? ResolvedStatus : UnresolvedStatus);
+	entry.expirationTime = (currentTime + (isResolved ? HOSTRESOLVER_POSITIVE_TTL : HOSTRESOLVER_NEGATIVE_TTL));
+
+	m_statistics.totalLatency += (currentTime - entry.requestTime);
+	++m_statistics.finishedLookups;
+
+	if (m_hosts.count() > HOSTRESOLVER_CACHE_SIZE)
+	{
+		pruneCache(currentTime);
+	}
+
+	emit hostResolved(host, isResolved);
+}
+
+void HostResolver::pruneCache(qint64 currentTime)
+{
+	QHash<QString, HostEntry>::iterator iterator(m_hosts.begin());
+
+	while (iterator != m_hosts.end())
+	{
+		if (iterator.value().status != ResolvingStatus && iterator.value().expirationTime <= currentTime)
+		{
+			iterator = m_hosts.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+}
+
+void HostResolver::resolveHost(const QString &host)
+{
+	if (host.isEmpty())
+	{
+		return;
+	}
+
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+
+	if (m_hosts.contains(host))
+	{
+		const HostEntry &entry(m_hosts[host]);
+
+		if (entry.status == ResolvingStatus || entry.expirationTime > currentTime)
+		{
+			return;
+		}
+	}
+
+	HostEntry entry;
+	entry.requestTime = currentTime;
+	entry.status = ResolvingStatus;
+
+	m_hosts[host] = entry;
+	m_lookups[QHostInfo::lookupHost(host, getInstance(), SLOT(handleLookup(QHostInfo)))] = host;
+
+	++m_statistics.lookups;
+}
+
+HostResolver* HostResolver::getInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new HostResolver(QCoreApplication::instance());
+	}
+
+	return m_instance;
+}
+
+HostResolver::HostStatus HostResolver::getHostStatus(const QString &host)
+{
+	if (m_hosts.contains(host))
+	{
+		const HostEntry &entry(m_hosts[host]);
+
+		if (entry.status != ResolvingStatus && entry.expirationTime > QDateTime::currentMSecsSinceEpoch())
+		{
+			++m_statistics.hits;
+
+			return entry.status;
+		}
+
+		if (entry.status == ResolvingStatus)
+		{
+			++m_statistics.misses;
+
+			return ResolvingStatus;
+		}
+	}
+
+	++m_statistics.misses;
+
+	return UnknownStatus;
+}
+
+HostResolver::ResolverStatistics HostResolver::getStatistics()
+{
+	return m_statistics;
+}
+
+QString HostResolver::getReport()
+{
+	QString report;
+	QTextStream stream(&report);
+	stream.setFieldAlignment(QTextStream::AlignLeft);
+	stream << QLatin1String("Host Lookups:\n\t");
+	stream.setFieldWidth(30);
+	stream << QLatin1String("Lookups");
+	stream << m_statistics.lookups;
+	stream.setFieldWidth(0);
+	stream << QLatin1String("\n\t");
+	stream.setFieldWidth(30);
+	stream << QLatin1String("Average Latency");
+	stream << QStringLiteral("%1 ms").arg(m_statistics.getAverageLatency());
+	stream.setFieldWidth(0);
+	stream << QLatin1String("\n\t");
+	stream.setFieldWidth(30);
+	stream << QLatin1String("Cache Hits");
+	stream << m_statistics.hits;
+	stream.setFieldWidth(0);
+	stream << QLatin1String("\n\t");
+	stream.setFieldWidth(30);
+	stream << QLatin1String("Cache Misses");
+	stream << m_statistics.misses;
+	stream.setFieldWidth(0);
+	stream << QLatin1String("\n\n");
+
+	return report;
+}
+
+}
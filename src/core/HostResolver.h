@@ -0,0 +1,94 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2016 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HOSTRESOLVER_H
+#define OTTER_HOSTRESOLVER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtNetwork/QHostInfo>
+
+namespace Otter
+{
+
+class HostResolver : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum HostStatus
+	{
+		UnknownStatus = 0,
+		ResolvingStatus,
+		ResolvedStatus,
+		UnresolvedStatus
+	};
+
+	struct ResolverStatistics
+	{
+		qint64 totalLatency;
+		int hits;
+		int misses;
+		int lookups;
+		int finishedLookups;
+
+		ResolverStatistics() : totalLatency(0), hits(0), misses(0), lookups(0), finishedLookups(0) {}
+
+		qint64 getAverageLatency() const
+		{
+			return ((finishedLookups > 0) ? (totalLatency / finishedLookups) : 0);
+		}
+	};
+
+	static HostResolver* getInstance();
+	static HostStatus getHostStatus(const QString &host);
+	static void resolveHost(const QString &host);
+	static ResolverStatistics getStatistics();
+	static QString getReport();
+
+protected:
+	struct HostEntry
+	{
+		qint64 requestTime;
+		qint64 expirationTime;
+		HostStatus status;
+
+		HostEntry() : requestTime(0), expirationTime(0), status(UnknownStatus) {}
+	};
+
+	explicit HostResolver(QObject *parent = NULL);
+
+	static void pruneCache(qint64 currentTime);
+
+protected slots:
+	void handleLookup(const QHostInfo &information);
+
+private:
+	static HostResolver *m_instance;
+	static QHash<QString, HostEntry> m_hosts;
+	static QHash<int, QString> m_lookups;
+	static ResolverStatistics m_statistics;
+
+signals:
+	void hostResolved(const QString &host, bool isResolved);
+};
+
+}
+
+#endif
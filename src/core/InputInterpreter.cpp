@@ -20,17 +20,18 @@
 
 #include "InputInterpreter.h"
 #include "BookmarksManager.h"
+#include "HostResolver.h"
 #include "SearchEnginesManager.h"
 #include "Utils.h"
 
 #include <QtCore/QFileInfo>
 #include <QtCore/QRegularExpression>
+#include <QtNetwork/QHostAddress>
 
 namespace Otter
 {
 
 InputInterpreter::InputInterpreter(QObject *parent) : QObject(parent),
-	m_lookup(0),
 	m_timer(0)
 {
 }
@@ -39,25 +40,30 @@ void InputInterpreter::timerEvent(QTimerEvent *event)
 {
 	if (event->timerId() == m_timer)
 	{
-		QHostInfo::abortHostLookup(m_lookup);
-
 		killTimer(m_timer);
 
 		m_timer = 0;
 
+		disconnect(HostResolver::getInstance(), SIGNAL(hostResolved(QString,bool)), this, SLOT(verifyLookup(QString,bool)));
+
 		emit requestedSearch(m_text, SettingsManager::getValue(QLatin1String("Search/DefaultSearchEngine")).toString(), m_hints);
 
 		m_text.clear();
 	}
 }
 
-void InputInterpreter::verifyLookup(const QHostInfo &host)
+void InputInterpreter::verifyLookup(const QString &host, bool isResolved)
 {
+	if (m_timer == 0 || host != m_host)
+	{
+		return;
+	}
+
 	killTimer(m_timer);
 
 	m_timer = 0;
 
-	if (host.error() == QHostInfo::NoError)
+	if (isResolved)
 	{
 		emit requestedOpenUrl(QUrl::fromUserInput(m_text), m_hints);
 	}
@@ -158,19 +164,41 @@ void InputInterpreter::interpret(const QString &text, WindowsManager::OpenHints
 
 	if (url.isValid() && lookupTimeout > 0)
 	{
+		const HostResolver::HostStatus status(HostResolver::getHostStatus(url.host()));
+
+		if (status == HostResolver::ResolvedStatus)
+		{
+			emit requestedOpenUrl(url, hints);
+
+			deleteLater();
+
+			return;
+		}
+
+		if (status == HostResolver::UnresolvedStatus)
+		{
+			emit requestedSearch(text, QString(), hints);
+
+			deleteLater();
+
+			return;
+		}
+
 		m_text = text;
+		m_host = url.host();
 		m_hints = hints;
 
 		if (m_timer != 0)
 		{
-			QHostInfo::abortHostLookup(m_lookup);
-
 			killTimer(m_timer);
 
 			m_timer = 0;
 		}
 
-		m_lookup = QHostInfo::lookupHost(url.host(), this, SLOT(verifyLookup(QHostInfo)));
+		connect(HostResolver::getInstance(), SIGNAL(hostResolved(QString,bool)), this, SLOT(verifyLookup(QString,bool)), Qt::UniqueConnection);
+
+		HostResolver::resolveHost(m_host);
+
 		m_timer = startTimer(lookupTimeout);
 
 		return;
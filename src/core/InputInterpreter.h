@@ -22,8 +22,6 @@
 
 #include "../core/WindowsManager.h"
 
-#include <QtNetwork/QHostInfo>
-
 namespace Otter
 {
 
@@ -40,12 +38,12 @@ protected:
 	void timerEvent(QTimerEvent *event);
 
 protected slots:
-	void verifyLookup(const QHostInfo &host);
+	void verifyLookup(const QString &host, bool isResolved);
 
 private:
 	QString m_text;
+	QString m_host;
 	WindowsManager::OpenHints m_hints;
-	int m_lookup;
 	int m_timer;
 
 signals:
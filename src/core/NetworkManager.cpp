@@ -177,4 +177,147 @@ QNetworkReply* NetworkManager::createRequest(QNetworkAccessManager::Operation op
 	return QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
 }
 
+NetworkManager::ResourceType NetworkManager::getResourceType(const QNetworkRequest &request)
+{
+	const QByteArray acceptHeader(request.rawHeader(QByteArray("Accept")));
+	const char *data(acceptHeader.constData());
+	const int length(acceptHeader.length());
+	int start(0);
+
+	while (start < length)
+	{
+		int end(acceptHeader.indexOf(',', start));
+
+		if (end < 0)
+		{
+			end = length;
+		}
+
+		int rangeEnd(start);
+
+		while (rangeEnd < end && data[rangeEnd] != ';')
+		{
+			++rangeEnd;
+		}
+
+		int rangeStart(start);
+
+		while (rangeStart < rangeEnd && data[rangeStart] == ' ')
+		{
+			++rangeStart;
+		}
+
+		while (rangeEnd > rangeStart && data[rangeEnd - 1] == ' ')
+		{
+			--rangeEnd;
+		}
+
+		const ResourceType type(getMediaRangeType((data + rangeStart), (rangeEnd - rangeStart)));
+
+		if (type != OtherType)
+		{
+			return type;
+		}
+
+		start = (end + 1);
+	}
+
+	const ResourceType type(getResourceType(request.url()));
+
+	if (type == OtherType && request.rawHeader(QByteArray("X-Requested-With")) == QByteArray("XMLHttpRequest"))
+	{
+		return XmlHttpRequestType;
+	}
+
+	return type;
+}
+
+NetworkManager::ResourceType NetworkManager::getResourceType(const QUrl &url)
+{
+	static const QHash<QString, ResourceType> extensions({
+		{QLatin1String("htm"), SubFrameType},
+		{QLatin1String("html"), SubFrameType},
+		{QLatin1String("xhtml"), SubFrameType},
+		{QLatin1String("css"), StyleSheetType},
+		{QLatin1String("js"), ScriptType},
+		{QLatin1String("mjs"), ScriptType},
+		{QLatin1String("apng"), ImageType},
+		{QLatin1String("avif"), ImageType},
+		{QLatin1String("bmp"), ImageType},
+		{QLatin1String("gif"), ImageType},
+		{QLatin1String("ico"), ImageType},
+		{QLatin1String("jpeg"), ImageType},
+		{QLatin1String("jpg"), ImageType},
+		{QLatin1String("png"), ImageType},
+		{QLatin1String("svg"), ImageType},
+		{QLatin1String("webp"), ImageType},
+		{QLatin1String("flv"), ObjectType},
+		{QLatin1String("m4a"), ObjectType},
+		{QLatin1String("mp3"), ObjectType},
+		{QLatin1String("mp4"), ObjectType},
+		{QLatin1String("ogg"), ObjectType},
+		{QLatin1String("swf"), ObjectType},
+		{QLatin1String("webm"), ObjectType}
+	});
+	const QString path(url.path());
+	const int dot(path.lastIndexOf(QLatin1Char('.')));
+
+	if (dot < 0 || dot < path.lastIndexOf(QLatin1Char('/')) || (path.length() - dot) > 6)
+	{
+		return OtherType;
+	}
+
+	return extensions.value(path.mid(dot + 1).toLower(), OtherType);
+}
+
+NetworkManager::ResourceType NetworkManager::getMediaRangeType(const char *range, int length)
+{
+	const int separator(QByteArray::fromRawData(range, length).indexOf('/'));
+
+	if (separator <= 0)
+	{
+		return OtherType;
+	}
+
+	const QByteArray type(QByteArray::fromRawData(range, separator));
+	const QByteArray subtype(QByteArray::fromRawData((range + separator + 1), (length - separator - 1)));
+
+	if (type == "image")
+	{
+		return ImageType;
+	}
+
+	if (type == "audio" || type == "video")
+	{
+		return ObjectType;
+	}
+
+	if ((type == "text" && subtype == "html") || (type == "application" && (subtype == "xhtml+xml" || subtype == "xml")))
+	{
+		return SubFrameType;
+	}
+
+	if (type == "text" && subtype == "css")
+	{
+		return StyleSheetType;
+	}
+
+	if (type == "script" || subtype.endsWith("javascript") || subtype.endsWith("ecmascript"))
+	{
+		return ScriptType;
+	}
+
+	if (type == "application" && subtype == "json")
+	{
+		return XmlHttpRequestType;
+	}
+
+	if (subtype.contains("object"))
+	{
+		return ObjectType;
+	}
+
+	return OtherType;
+}
+
 }
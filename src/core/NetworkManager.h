@@ -48,9 +48,12 @@ public:
 	explicit NetworkManager(bool isPrivate = false, QObject *parent = NULL);
 
 	CookieJar* getCookieJar();
+	static ResourceType getResourceType(const QNetworkRequest &request);
+	static ResourceType getResourceType(const QUrl &url);
 
 protected:
 	virtual QNetworkReply* createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData);
+	static ResourceType getMediaRangeType(const char *range, int length);
 
 protected slots:
 	void handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator);
@@ -32,10 +32,29 @@
 namespace Otter
 {
 
+SearchEngineItem::SearchEngineItem(const QString &identifier) : QStandardItem()
+{
+	setData(identifier, (Qt::UserRole + 1));
+}
+
+QVariant SearchEngineItem::data(int role) const
+{
+	if (role == Qt::DecorationRole)
+	{
+		const QIcon icon(SearchEnginesManager::getSearchEngine(QStandardItem::data(Qt::UserRole + 1).toString()).icon);
+
+		return (icon.isNull() ? ThemesManager::getIcon(QLatin1String("edit-find")) : icon);
+	}
+
+	return QStandardItem::data(role);
+}
+
 SearchEnginesManager* SearchEnginesManager::m_instance = NULL;
 QStandardItemModel* SearchEnginesManager::m_searchEnginesModel = NULL;
 QStringList SearchEnginesManager::m_searchEnginesOrder;
 QStringList SearchEnginesManager::m_searchKeywords;
+QHash<QString, QString> SearchEnginesManager::m_searchKeywordsIdentifiers;
+QHash<QString, QString> SearchEnginesManager::m_searchEnginesTitles;
 QHash<QString, SearchEnginesManager::SearchEngineDefinition> SearchEnginesManager::m_searchEngines;
 bool SearchEnginesManager::m_isInitialized = false;
 
@@ -71,10 +90,19 @@ void SearchEnginesManager::optionChanged(const QString &key)
 	}
 }
 
+void SearchEnginesManager::handleSearchEngineRemoved()
+{
+	emit searchEnginesModified();
+
+	updateSearchEnginesModel();
+}
+
 void SearchEnginesManager::loadSearchEngines()
 {
 	m_searchEngines.clear();
 	m_searchKeywords.clear();
+	m_searchKeywordsIdentifiers.clear();
+	m_searchEnginesTitles.clear();
 
 	m_searchEnginesOrder = SettingsManager::getValue(QLatin1String("Search/SearchEnginesOrder")).toStringList();
 
@@ -83,25 +111,25 @@ void SearchEnginesManager::loadSearchEngines()
 	for (int i = 0; i < searchEnginesOrder.count(); ++i)
 	{
 		QFile file(SessionsManager::getReadableDataPath(QLatin1String("searches/") + searchEnginesOrder.at(i) + QLatin1String(".xml")));
+		QString title;
+		QString keyword;
 
-		if (!file.open(QIODevice::ReadOnly))
+		if (!file.open(QIODevice::ReadOnly) || !scanSearchEngine(&file, &title, &keyword))
 		{
 			m_searchEnginesOrder.removeAll(searchEnginesOrder.at(i));
 
 			continue;
 		}
 
-		SearchEngineDefinition searchEngine(loadSearchEngine(&file, searchEnginesOrder.at(i), true));
-
 		file.close();
 
-		if (searchEngine.identifier.isEmpty())
-		{
-			m_searchEnginesOrder.removeAll(searchEnginesOrder.at(i));
-		}
-		else
+		m_searchEnginesTitles[searchEnginesOrder.at(i)] = title;
+
+		if (!keyword.isEmpty() && !m_searchKeywordsIdentifiers.contains(keyword))
 		{
-			m_searchEngines[searchEnginesOrder.at(i)] = searchEngine;
+			m_searchKeywords.append(keyword);
+
+			m_searchKeywordsIdentifiers[keyword] = searchEnginesOrder.at(i);
 		}
 	}
 
@@ -147,17 +175,11 @@ void SearchEnginesManager::updateSearchEnginesModel()
 
 	for (int i = 0; i < searchEngines.count(); ++i)
 	{
-		const SearchEngineDefinition search(getSearchEngine(searchEngines.at(i)));
+		SearchEngineItem *item(new SearchEngineItem(searchEngines.at(i)));
+		item->setData(m_searchEnginesTitles.value(searchEngines.at(i)), Qt::UserRole);
+		item->setData(m_searchKeywordsIdentifiers.key(searchEngines.at(i)), (Qt::UserRole + 2));
 
-		if (!search.identifier.isEmpty())
-		{
-			QStandardItem *item(new QStandardItem((search.icon.isNull() ? ThemesManager::getIcon(QLatin1String("edit-find")) : search.icon), QString()));
-			item->setData(search.title, Qt::UserRole);
-			item->setData(search.identifier, (Qt::UserRole + 1));
-			item->setData(search.keyword, (Qt::UserRole + 2));
-
-			m_searchEnginesModel->appendRow(item);
-		}
+		m_searchEnginesModel->appendRow(item);
 	}
 
 	if (searchEngines.count() > 0)
@@ -176,6 +198,29 @@ void SearchEnginesManager::updateSearchEnginesModel()
 	emit m_instance->searchEnginesModelModified();
 }
 
+void SearchEnginesManager::updateSearchKeyword(const QString &identifier, const QString &keyword)
+{
+	const QString oldKeyword(m_searchKeywordsIdentifiers.key(identifier));
+
+	if (oldKeyword == keyword)
+	{
+		return;
+	}
+
+	if (!oldKeyword.isEmpty())
+	{
+		m_searchKeywords.removeAll(oldKeyword);
+		m_searchKeywordsIdentifiers.remove(oldKeyword);
+	}
+
+	if (!keyword.isEmpty() && !m_searchKeywordsIdentifiers.contains(keyword))
+	{
+		m_searchKeywords.append(keyword);
+
+		m_searchKeywordsIdentifiers[keyword] = identifier;
+	}
+}
+
 void SearchEnginesManager::setupQuery(const QString &query, const SearchUrl &searchUrl, QNetworkRequest *request, QNetworkAccessManager::Operation *method, QByteArray *body)
 {
 	if (searchUrl.url.isEmpty())
@@ -326,18 +371,9 @@ SearchEnginesManager::SearchEngineDefinition SearchEnginesManager::loadSearchEng
 				{
 					const QString keyword(reader.readElementText());
 
-					if (!keyword.isEmpty())
+					if (!keyword.isEmpty() && (!checkKeyword || !m_searchKeywordsIdentifiers.contains(keyword)))
 					{
-						if (!m_searchKeywords.contains(keyword))
-						{
-							searchEngine.keyword = keyword;
-
-							m_searchKeywords.append(keyword);
-						}
-						else if (!checkKeyword)
-						{
-							searchEngine.keyword = keyword;
-						}
+						searchEngine.keyword = keyword;
 					}
 				}
 				else if (reader.name() == QLatin1String("ShortName"))
@@ -373,6 +409,41 @@ SearchEnginesManager::SearchEngineDefinition SearchEnginesManager::loadSearchEng
 	return searchEngine;
 }
 
+bool SearchEnginesManager::scanSearchEngine(QIODevice *device, QString *title, QString *keyword)
+{
+	QXmlStreamReader reader(device);
+
+	if (!reader.readNextStartElement() || reader.name() != QLatin1String("OpenSearchDescription"))
+	{
+		return false;
+	}
+
+	bool hasTitle(false);
+	bool hasKeyword(false);
+
+	while ((!hasTitle || !hasKeyword) && reader.readNextStartElement())
+	{
+		if (reader.name() == QLatin1String("ShortName"))
+		{
+			*title = reader.readElementText();
+
+			hasTitle = true;
+		}
+		else if (reader.name() == QLatin1String("Shortcut"))
+		{
+			*keyword = reader.readElementText();
+
+			hasKeyword = true;
+		}
+		else
+		{
+			reader.skipCurrentElement();
+		}
+	}
+
+	return true;
+}
+
 SearchEnginesManager* SearchEnginesManager::getInstance()
 {
 	return m_instance;
@@ -404,28 +475,51 @@ SearchEnginesManager::SearchEngineDefinition SearchEnginesManager::getSearchEngi
 
 	if (byKeyword)
 	{
-		if (!identifier.isEmpty())
+		if (identifier.isEmpty() || !m_searchKeywordsIdentifiers.contains(identifier))
 		{
-			QHash<QString, SearchEngineDefinition>::iterator iterator;
-
-			for (iterator = m_searchEngines.begin(); iterator != m_searchEngines.end(); ++iterator)
-			{
-				if (iterator.value().keyword == identifier)
-				{
-					return iterator.value();
-				}
-			}
+			return SearchEngineDefinition();
 		}
 
-		return SearchEngineDefinition();
+		return getSearchEngine(m_searchKeywordsIdentifiers[identifier]);
 	}
 
-	if (identifier.isEmpty())
+	const QString searchEngine(identifier.isEmpty() ? SettingsManager::getValue(QLatin1String("Search/DefaultSearchEngine")).toString() : identifier);
+
+	if (!m_searchEngines.contains(searchEngine))
 	{
-		return m_searchEngines.value(SettingsManager::getValue(QLatin1String("Search/DefaultSearchEngine")).toString(), SearchEngineDefinition());
+		if (!m_searchEnginesOrder.contains(searchEngine))
+		{
+			return SearchEngineDefinition();
+		}
+
+		QFile file(SessionsManager::getReadableDataPath(QLatin1String("searches/") + searchEngine + QLatin1String(".xml")));
+
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			return SearchEngineDefinition();
+		}
+
+		SearchEngineDefinition definition(loadSearchEngine(&file, searchEngine, false));
+		definition.keyword = m_searchKeywordsIdentifiers.key(searchEngine);
+
+		file.close();
+
+		if (definition.identifier.isEmpty())
+		{
+			m_searchEnginesOrder.removeAll(searchEngine);
+			m_searchEnginesTitles.remove(searchEngine);
+
+			updateSearchKeyword(searchEngine, QString());
+
+			QMetaObject::invokeMethod(m_instance, "handleSearchEngineRemoved", Qt::QueuedConnection);
+
+			return SearchEngineDefinition();
+		}
+
+		m_searchEngines[searchEngine] = definition;
 	}
 
-	return m_searchEngines.value(identifier, SearchEngineDefinition());
+	return m_searchEngines[searchEngine];
 }
 
 QStringList SearchEnginesManager::getSearchEngines()
@@ -559,6 +653,14 @@ bool SearchEnginesManager::saveSearchEngine(const SearchEngineDefinition &search
 	writer.writeEndElement();
 	writer.writeEndDocument();
 
+	if (m_isInitialized && m_searchEnginesOrder.contains(searchEngine.identifier))
+	{
+		m_searchEngines.remove(searchEngine.identifier);
+		m_searchEnginesTitles[searchEngine.identifier] = searchEngine.title;
+
+		updateSearchKeyword(searchEngine.identifier, searchEngine.keyword);
+	}
+
 	return true;
 }
 
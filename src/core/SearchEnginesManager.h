@@ -29,6 +29,17 @@
 namespace Otter
 {
 
+class SearchEngineItem : public QStandardItem
+{
+public:
+	QVariant data(int role) const;
+
+protected:
+	explicit SearchEngineItem(const QString &identifier);
+
+friend class SearchEnginesManager;
+};
+
 class SearchEnginesManager : public QObject
 {
 	Q_OBJECT
@@ -78,15 +89,20 @@ protected:
 
 	static void initialize();
 	static void updateSearchEnginesModel();
+	static void updateSearchKeyword(const QString &identifier, const QString &keyword);
+	static bool scanSearchEngine(QIODevice *device, QString *title, QString *keyword);
 
 protected slots:
 	void optionChanged(const QString &key);
+	void handleSearchEngineRemoved();
 
 private:
 	static SearchEnginesManager *m_instance;
 	static QStandardItemModel *m_searchEnginesModel;
 	static QStringList m_searchEnginesOrder;
 	static QStringList m_searchKeywords;
+	static QHash<QString, QString> m_searchKeywordsIdentifiers;
+	static QHash<QString, QString> m_searchEnginesTitles;
 	static QHash<QString, SearchEngineDefinition> m_searchEngines;
 	static bool m_isInitialized;
 
@@ -24,15 +24,85 @@
 
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QTimerEvent>
+
+#define SEARCHSUGGESTER_CACHE_SIZE 100
+#define SEARCHSUGGESTER_MAXIMUM_DELAY 300
+#define SEARCHSUGGESTER_MINIMUM_DELAY 50
 
 namespace Otter
 {
 
+QHash<QString, QList<SearchSuggester::SearchSuggestion> > SearchSuggester::m_cache;
+QStringList SearchSuggester::m_cacheOrder;
+
 SearchSuggester::SearchSuggester(const QString &searchEngine, QObject *parent) : QObject(parent),
 	m_networkReply(NULL),
 	m_model(NULL),
-	m_searchEngine(searchEngine)
+	m_searchEngine(searchEngine),
+	m_requestTimerIdentifier(0),
+	m_averageLatency(SEARCHSUGGESTER_MAXIMUM_DELAY),
+	m_isPrivate(false)
+{
+}
+
+void SearchSuggester::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_requestTimerIdentifier)
+	{
+		killTimer(m_requestTimerIdentifier);
+
+		m_requestTimerIdentifier = 0;
+
+		sendRequest();
+	}
+}
+
+void SearchSuggester::sendRequest()
 {
+	if (m_networkReply)
+	{
+		if (m_requestedQuery == m_query)
+		{
+			return;
+		}
+
+		QNetworkReply *reply(m_networkReply);
+
+		m_networkReply = NULL;
+
+		reply->abort();
+		reply->deleteLater();
+	}
+
+	const SearchEnginesManager::SearchEngineDefinition searchEngine(SearchEnginesManager::getSearchEngine(m_searchEngine));
+
+	if (m_query.isEmpty() || searchEngine.identifier.isEmpty() || searchEngine.suggestionsUrl.url.isEmpty())
+	{
+		return;
+	}
+
+	QNetworkRequest request;
+	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+
+	QNetworkAccessManager::Operation method;
+	QByteArray body;
+
+	SearchEnginesManager::setupQuery(m_query, searchEngine.suggestionsUrl, &request, &method, &body);
+
+	if (method == QNetworkAccessManager::PostOperation)
+	{
+		m_networkReply = NetworkManagerFactory::getNetworkManager()->post(request, body);
+	}
+	else
+	{
+		m_networkReply = NetworkManagerFactory::getNetworkManager()->get(request);
+	}
+
+	m_requestedQuery = m_query;
+	m_requestTimer.start();
+
+	connect(m_networkReply, SIGNAL(finished()), this, SLOT(replyFinished()));
 }
 
 void SearchSuggester::setSearchEngine(const QString &searchEngine)
@@ -47,94 +117,169 @@ void SearchSuggester::setSearchEngine(const QString &searchEngine)
 
 void SearchSuggester::setQuery(const QString &query)
 {
-	if (query != m_query)
+	if (query == m_query)
 	{
-		m_query = query;
+		return;
+	}
 
-		if (m_networkReply)
-		{
-			m_networkReply->abort();
-			m_networkReply->deleteLater();
-			m_networkReply = NULL;
-		}
+	m_query = query;
 
-		const SearchEnginesManager::SearchEngineDefinition searchEngine(SearchEnginesManager::getSearchEngine(m_searchEngine));
+	if (m_requestTimerIdentifier > 0)
+	{
+		killTimer(m_requestTimerIdentifier);
 
-		if (searchEngine.identifier.isEmpty() || searchEngine.suggestionsUrl.url.isEmpty())
-		{
-			return;
-		}
+		m_requestTimerIdentifier = 0;
+	}
 
-		QNetworkRequest request;
-		request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+	if (m_query.isEmpty())
+	{
+		setSuggestions(QList<SearchSuggestion>());
 
-		QNetworkAccessManager::Operation method;
-		QByteArray body;
+		return;
+	}
+
+	const QString key(getCacheKey(m_searchEngine, m_query));
+
+	if (m_cache.contains(key))
+	{
+		m_cacheOrder.removeOne(key);
+		m_cacheOrder.prepend(key);
+
+		setSuggestions(m_cache[key]);
+
+		return;
+	}
 
-		SearchEnginesManager::setupQuery(query, searchEngine.suggestionsUrl, &request, &method, &body);
+	for (int i = (m_query.length() - 1); i > 0; --i)
+	{
+		const QString prefixKey(getCacheKey(m_searchEngine, m_query.left(i)));
 
-		if (method == QNetworkAccessManager::PostOperation)
+		if (m_cache.contains(prefixKey))
 		{
-			m_networkReply = NetworkManagerFactory::getNetworkManager()->post(request, body);
+			const QList<SearchSuggestion> cachedSuggestions(m_cache[prefixKey]);
+			QList<SearchSuggestion> suggestions;
+
+			for (int j = 0; j < cachedSuggestions.count(); ++j)
+			{
+				if (cachedSuggestions.at(j).completion.startsWith(m_query, Qt::CaseInsensitive))
+				{
+					suggestions.append(cachedSuggestions.at(j));
+				}
+			}
+
+			setSuggestions(suggestions);
+
+			break;
 		}
-		else
+	}
+
+	m_requestTimerIdentifier = startTimer(qBound(SEARCHSUGGESTER_MINIMUM_DELAY, (m_averageLatency / 2), SEARCHSUGGESTER_MAXIMUM_DELAY));
+}
+
+void SearchSuggester::setSuggestions(const QList<SearchSuggestion> &suggestions)
+{
+	if (m_model)
+	{
+		m_model->setRowCount(suggestions.count());
+
+		for (int i = 0; i < suggestions.count(); ++i)
 		{
-			m_networkReply = NetworkManagerFactory::getNetworkManager()->get(request);
-		}
+			QStandardItem *item(m_model->item(i));
 
-		connect(m_networkReply, SIGNAL(finished()), this, SLOT(replyFinished()));
+			if (item)
+			{
+				item->setText(suggestions.at(i).completion);
+			}
+			else
+			{
+				m_model->setItem(i, new QStandardItem(suggestions.at(i).completion));
+			}
+		}
 	}
+
+	emit suggestionsChanged(suggestions);
 }
 
 void SearchSuggester::replyFinished()
 {
-	if (!m_networkReply)
+	QNetworkReply *reply(qobject_cast<QNetworkReply*>(sender()));
+
+	if (!reply || reply != m_networkReply)
 	{
 		return;
 	}
 
-	if (m_model)
+	m_networkReply->deleteLater();
+	m_networkReply = NULL;
+
+	m_averageLatency = (((m_averageLatency * 3) + static_cast<int>(m_requestTimer.elapsed())) / 4);
+
+	if (reply->error() != QNetworkReply::NoError || reply->size() <= 0)
 	{
-		m_model->clear();
+		setSuggestions(QList<SearchSuggestion>());
+
+		return;
 	}
 
-	m_networkReply->deleteLater();
+	const QJsonDocument document(QJsonDocument::fromJson(reply->readAll()));
 
-	if (m_networkReply->size() <= 0)
+	if (document.isEmpty() || !document.isArray() || document.array().count() < 2 || document.array().at(0).toString() != m_requestedQuery)
 	{
-		m_networkReply = NULL;
+		setSuggestions(QList<SearchSuggestion>());
 
 		return;
 	}
 
-	const QJsonDocument document(QJsonDocument::fromJson(m_networkReply->readAll()));
+	const QJsonArray completionsArray(document.array().at(1).toArray());
+	const QJsonArray descriptionsArray(document.array().at(2).toArray());
+	const QJsonArray urlsArray(document.array().at(3).toArray());
+	QList<SearchSuggestion> suggestions;
 
-	if (!document.isEmpty() && document.isArray() && document.array().count() > 1 && document.array().at(0).toString() == m_query)
+	for (int i = 0; i < completionsArray.count(); ++i)
 	{
-		const QJsonArray completionsArray(document.array().at(1).toArray());
-		const QJsonArray descriptionsArray(document.array().at(2).toArray());
-		const QJsonArray urlsArray(document.array().at(3).toArray());
-		QList<SearchSuggestion> suggestions;
+		SearchSuggestion suggestion;
+		suggestion.completion = completionsArray.at(i).toString();
+		suggestion.description = descriptionsArray.at(i).toString();
+		suggestion.url = urlsArray.at(i).toString();
 
-		for (int i = 0; i < completionsArray.count(); ++i)
-		{
-			SearchSuggestion suggestion;
-			suggestion.completion = completionsArray.at(i).toString();
-			suggestion.description = descriptionsArray.at(i).toString();
-			suggestion.url = urlsArray.at(i).toString();
+		suggestions.append(suggestion);
+	}
 
-			if (m_model)
-			{
-				m_model->appendRow(new QStandardItem(suggestion.completion));
-			}
+	if (!m_isPrivate)
+	{
+		addCacheEntry(getCacheKey(m_searchEngine, m_requestedQuery), suggestions);
+	}
 
-			suggestions.append(suggestion);
-		}
+	if (m_requestedQuery == m_query)
+	{
+		setSuggestions(suggestions);
+	}
+}
 
-		emit suggestionsChanged(suggestions);
+void SearchSuggester::addCacheEntry(const QString &key, const QList<SearchSuggestion> &suggestions)
+{
+	if (m_cache.contains(key))
+	{
+		m_cacheOrder.removeOne(key);
 	}
 
-	m_networkReply = NULL;
+	m_cache[key] = suggestions;
+	m_cacheOrder.prepend(key);
+
+	while (m_cacheOrder.count() > SEARCHSUGGESTER_CACHE_SIZE)
+	{
+		m_cache.remove(m_cacheOrder.takeLast());
+	}
+}
+
+QString SearchSuggester::getCacheKey(const QString &searchEngine, const QString &query)
+{
+	return searchEngine + QLatin1Char('\n') + query;
+}
+
+void SearchSuggester::setPrivate(bool isPrivate)
+{
+	m_isPrivate = isPrivate;
 }
 
 QStandardItemModel* SearchSuggester::getModel()
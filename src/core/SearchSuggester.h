@@ -20,6 +20,7 @@
 #ifndef OTTER_SEARCHSUGGESTER_H
 #define OTTER_SEARCHSUGGESTER_H
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtGui/QStandardItemModel>
 #include <QtNetwork/QNetworkReply>
@@ -44,19 +45,35 @@ public:
 	explicit SearchSuggester(const QString &searchEngine, QObject *parent = NULL);
 
 	QStandardItemModel* getModel();
+	void setPrivate(bool isPrivate);
 
 public slots:
 	void setSearchEngine(const QString &searchEngine);
 	void setQuery(const QString &query);
 
+protected:
+	void timerEvent(QTimerEvent *event);
+	void sendRequest();
+	void setSuggestions(const QList<SearchSuggestion> &suggestions);
+	static void addCacheEntry(const QString &key, const QList<SearchSuggestion> &suggestions);
+	static QString getCacheKey(const QString &searchEngine, const QString &query);
+
 protected slots:
 	void replyFinished();
 
 private:
 	QNetworkReply *m_networkReply;
 	QStandardItemModel *m_model;
+	QElapsedTimer m_requestTimer;
 	QString m_searchEngine;
 	QString m_query;
+	QString m_requestedQuery;
+	int m_requestTimerIdentifier;
+	int m_averageLatency;
+	bool m_isPrivate;
+
+	static QHash<QString, QList<SearchSuggestion> > m_cache;
+	static QStringList m_cacheOrder;
 
 signals:
 	void suggestionsChanged(const QList<SearchSuggestion> &suggestions);
@@ -71,13 +71,30 @@ void SettingsManager::createInstance(const QString &path, QObject *parent)
 
 void SettingsManager::removeOverride(const QUrl &url, const QString &key)
 {
+	QSettings settings(m_overridePath, QSettings::IniFormat);
+	QStringList keys;
+
 	if (key.isEmpty())
 	{
-		QSettings(m_overridePath, QSettings::IniFormat).remove(getHost(url));
+		settings.beginGroup(getHost(url));
+
+		keys = settings.allKeys();
+
+		settings.endGroup();
+		settings.remove(getHost(url));
 	}
 	else
 	{
-		QSettings(m_overridePath, QSettings::IniFormat).remove(getHost(url) + QLatin1Char('/') + key);
+		keys.append(key);
+
+		settings.remove(getHost(url) + QLatin1Char('/') + key);
+	}
+
+	settings.sync();
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		emit m_instance->valueChanged(keys.at(i), QVariant(), url);
 	}
 }
 
@@ -312,6 +329,29 @@ SettingsManager::OptionDefinition SettingsManager::getDefinition(const QString &
 	return options;
 }
 
+QStringList SettingsManager::getOverrideHosts(const QString &key)
+{
+	QSettings settings(m_overridePath, QSettings::IniFormat);
+	const QStringList hosts(settings.childGroups());
+
+	if (key.isEmpty())
+	{
+		return hosts;
+	}
+
+	QStringList matchingHosts;
+
+	for (int i = 0; i < hosts.count(); ++i)
+	{
+		if (settings.contains(hosts.at(i) + QLatin1Char('/') + key))
+		{
+			matchingHosts.append(hosts.at(i));
+		}
+	}
+
+	return matchingHosts;
+}
+
 bool SettingsManager::hasOverride(const QUrl &url, const QString &key)
 {
 	if (key.isEmpty())
@@ -65,6 +65,7 @@ public:
 	static QString getReport();
 	static QVariant getValue(const QString &key, const QUrl &url = QUrl());
 	static QStringList getOptions();
+	static QStringList getOverrideHosts(const QString &key = QString());
 	static OptionDefinition getDefinition(const QString &key);
 	static bool hasOverride(const QUrl &url, const QString &key = QString());
 
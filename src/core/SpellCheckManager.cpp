@@ -46,8 +46,6 @@ void SpellCheckManager::createInstance(QObject *parent)
 		m_instance = new SpellCheckManager(parent);
 #ifdef OTTER_ENABLE_SPELLCHECK
 		qputenv("OTTER_DICTIONARIES", SessionsManager::getWritableDataPath(QLatin1String("dictionaries")).toLatin1());
-
-		m_speller = new Sonnet::Speller();
 #endif
 	}
 }
@@ -57,10 +55,22 @@ SpellCheckManager* SpellCheckManager::getInstance()
 	return m_instance;
 }
 
+#ifdef OTTER_ENABLE_SPELLCHECK
+Sonnet::Speller* SpellCheckManager::getSpeller()
+{
+	if (!m_speller)
+	{
+		m_speller = new Sonnet::Speller();
+	}
+
+	return m_speller;
+}
+#endif
+
 QString SpellCheckManager::getDefaultDictionary()
 {
 #ifdef OTTER_ENABLE_SPELLCHECK
-	return m_speller->defaultLanguage();
+	return getSpeller()->defaultLanguage();
 #else
 	return QString();
 #endif
@@ -71,7 +81,7 @@ QList<SpellCheckManager::DictionaryInformation> SpellCheckManager::getDictionari
 	QList<DictionaryInformation> dictionaries;
 
 #ifdef OTTER_ENABLE_SPELLCHECK
-	const QMap<QString, QString> availableDictionaries(m_speller->availableDictionaries());
+	const QMap<QString, QString> availableDictionaries(getSpeller()->availableDictionaries());
 	QMap<QString, QString>::const_iterator iterator;
 
 	for (iterator = availableDictionaries.constBegin(); iterator != availableDictionaries.constEnd(); ++iterator)
@@ -50,6 +50,10 @@ public:
 protected:
 	explicit SpellCheckManager(QObject *parent = NULL);
 
+#ifdef OTTER_ENABLE_SPELLCHECK
+	static Sonnet::Speller* getSpeller();
+#endif
+
 private:
 	static SpellCheckManager *m_instance;
 #ifdef OTTER_ENABLE_SPELLCHECK
@@ -0,0 +1,166 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2016 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "StartupTrace.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+namespace Otter
+{
+
+QElapsedTimer StartupTrace::m_timer;
+QString StartupTrace::m_path;
+QVector<StartupTrace::TraceEvent> StartupTrace::m_events;
+QVector<int> StartupTrace::m_openEvents;
+bool StartupTrace::m_isEnabled = false;
+
+void StartupTrace::start(const QString &path)
+{
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	m_path = path;
+	m_isEnabled = true;
+
+	m_timer.start();
+}
+
+void StartupTrace::beginEvent(const QString &name, const QString &category)
+{
+	if (!m_isEnabled)
+	{
+		return;
+	}
+
+	TraceEvent event;
+	event.name = name;
+	event.category = category;
+	event.start = m_timer.nsecsElapsed();
+	event.duration = 0;
+
+	m_openEvents.append(m_events.count());
+	m_events.append(event);
+}
+
+void StartupTrace::endEvent()
+{
+	if (!m_isEnabled || m_openEvents.isEmpty())
+	{
+		return;
+	}
+
+	TraceEvent &event(m_events[m_openEvents.takeLast()]);
+	event.duration = (m_timer.nsecsElapsed() - event.start);
+}
+
+void StartupTrace::markEvent(const QString &name, const QString &category)
+{
+	if (!m_isEnabled)
+	{
+		return;
+	}
+
+	TraceEvent event;
+	event.name = name;
+	event.category = category;
+	event.start = m_timer.nsecsElapsed();
+
+	m_events.append(event);
+}
+
+bool StartupTrace::save()
+{
+	if (!m_isEnabled)
+	{
+		return false;
+	}
+
+	while (!m_openEvents.isEmpty())
+	{
+		endEvent();
+	}
+
+	const double processIdentifier(QCoreApplication::applicationPid());
+	QJsonArray events;
+
+	for (int i = 0; i < m_events.count(); ++i)
+	{
+		const TraceEvent &event(m_events.at(i));
+		QJsonObject object;
+		object.insert(QLatin1String("name"), event.name);
+		object.insert(QLatin1String("cat"), event.category);
+		object.insert(QLatin1String("ts"), (event.start / 1000.0));
+		object.insert(QLatin1String("pid"), processIdentifier);
+		object.insert(QLatin1String("tid"), 1);
+
+		if (event.duration < 0)
+		{
+			object.insert(QLatin1String("ph"), QLatin1String("i"));
+			object.insert(QLatin1String("s"), QLatin1String("g"));
+		}
+		else
+		{
+			object.insert(QLatin1String("ph"), QLatin1String("X"));
+			object.insert(QLatin1String("dur"), (event.duration / 1000.0));
+		}
+
+		events.append(object);
+	}
+
+	QJsonObject trace;
+	trace.insert(QLatin1String("traceEvents"), events);
+	trace.insert(QLatin1String("displayTimeUnit"), QLatin1String("ms"));
+
+	m_isEnabled = false;
+	m_events.clear();
+
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+
+	return file.commit();
+}
+
+bool StartupTrace::isEnabled()
+{
+	return m_isEnabled;
+}
+
+StartupTraceScope::StartupTraceScope(const QString &name, const QString &category)
+{
+	StartupTrace::beginEvent(name, category);
+}
+
+StartupTraceScope::~StartupTraceScope()
+{
+	StartupTrace::endEvent();
+}
+
+}
@@ -0,0 +1,73 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2016 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_STARTUPTRACE_H
+#define OTTER_STARTUPTRACE_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#define STARTUP_TRACE_MANAGER(manager, ...) do { const Otter::StartupTraceScope trace(QLatin1String(#manager), QLatin1String("manager")); manager::createInstance(__VA_ARGS__); } while (false)
+
+namespace Otter
+{
+
+class StartupTrace
+{
+public:
+	static void start(const QString &path);
+	static void beginEvent(const QString &name, const QString &category = QLatin1String("startup"));
+	static void endEvent();
+	static void markEvent(const QString &name, const QString &category = QLatin1String("startup"));
+	static bool save();
+	static bool isEnabled();
+
+protected:
+	struct TraceEvent
+	{
+		QString name;
+		QString category;
+		qint64 start;
+		qint64 duration;
+
+		TraceEvent() : start(0), duration(-1) {}
+	};
+
+private:
+	static QElapsedTimer m_timer;
+	static QString m_path;
+	static QVector<TraceEvent> m_events;
+	static QVector<int> m_openEvents;
+	static bool m_isEnabled;
+};
+
+class StartupTraceScope
+{
+public:
+	explicit StartupTraceScope(const QString &name, const QString &category = QLatin1String("startup"));
+	~StartupTraceScope();
+
+private:
+	Q_DISABLE_COPY(StartupTraceScope)
+};
+
+}
+
+#endif
@@ -18,6 +18,7 @@
 **************************************************************************/
 
 #include "TransfersManager.h"
+#include "Console.h"
 #include "NetworkManager.h"
 #include "NetworkManagerFactory.h"
 #include "NotificationsManager.h"
@@ -33,6 +34,11 @@
 #include <QtCore/QTimer>
 #include <QtWidgets/QMessageBox>
 
+#define TRANSFER_BUFFER_SIZE 1048576
+#define TRANSFER_READ_BUFFER_SIZE 4194304
+#define TRANSFER_SEGMENT_MINIMUM_SIZE 1048576
+#define TRANSFER_SEGMENT_RETRIES 3
+
 namespace Otter
 {
 
@@ -49,6 +55,7 @@ Transfer::Transfer(TransferOptions options, QObject *parent) : QObject(parent ?
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(0),
 	m_bytesTotal(0),
+	m_bufferedBytes(0),
 	m_options(options),
 	m_state(UnknownState),
 	m_updateTimer(0),
@@ -70,6 +77,7 @@ Transfer::Transfer(const QSettings &settings, QObject *parent) : QObject(parent
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(settings.value(QLatin1String("bytesReceived")).toLongLong()),
 	m_bytesTotal(settings.value(QLatin1String("bytesTotal")).toLongLong()),
+	m_bufferedBytes(0),
 	m_options(NoOption),
 	m_state((m_bytesReceived > 0 && m_bytesTotal == m_bytesReceived) ? FinishedState : ErrorState),
 	m_updateTimer(0),
@@ -88,6 +96,7 @@ Transfer::Transfer(const QUrl &source, const QString &target, TransferOptions op
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(0),
 	m_bytesTotal(0),
+	m_bufferedBytes(0),
 	m_options(options),
 	m_state(UnknownState),
 	m_updateTimer(0),
@@ -112,6 +121,7 @@ Transfer::Transfer(const QNetworkRequest &request, const QString &target, Transf
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(0),
 	m_bytesTotal(0),
+	m_bufferedBytes(0),
 	m_options(options),
 	m_state(UnknownState),
 	m_updateTimer(0),
@@ -130,6 +140,7 @@ Transfer::Transfer(QNetworkReply *reply, const QString &target, TransferOptions
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(0),
 	m_bytesTotal(0),
+	m_bufferedBytes(0),
 	m_options(options),
 	m_state(UnknownState),
 	m_updateTimer(0),
@@ -141,6 +152,8 @@ Transfer::Transfer(QNetworkReply *reply, const QString &target, TransferOptions
 
 Transfer::~Transfer()
 {
+	stopSegments();
+
 	if (m_options.testFlag(HasToOpenAfterFinishOption) && QFile::exists(m_target))
 	{
 		QFile::remove(m_target);
@@ -178,6 +191,7 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 	}
 
 	m_reply = reply;
+	m_reply->setReadBufferSize(TRANSFER_READ_BUFFER_SIZE);
 	m_mimeType = QMimeDatabase().mimeTypeForName(m_reply->header(QNetworkRequest::ContentTypeHeader).toString());
 
 	QString temporaryFileName(getSuggestedFileName());
@@ -222,6 +236,7 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 		connect(m_reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(downloadProgress(qint64,qint64)));
 		connect(m_reply, SIGNAL(finished()), this, SLOT(downloadFinished()));
 		connect(m_reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(downloadError(QNetworkReply::NetworkError)));
+		connect(m_reply, SIGNAL(metaDataChanged()), this, SLOT(startSegments()));
 	}
 	else
 	{
@@ -233,6 +248,8 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 		}
 	}
 
+	flushData();
+
 	m_device->reset();
 
 	m_mimeType = QMimeDatabase().mimeTypeForData(m_device);
@@ -324,6 +341,10 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 			m_mimeType = QMimeDatabase().mimeTypeForFile(m_target);
 		}
 	}
+	else if (m_state == RunningState)
+	{
+		startSegments();
+	}
 }
 
 void Transfer::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
@@ -337,7 +358,7 @@ void Transfer::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 
 void Transfer::downloadData()
 {
-	if (!m_reply)
+	if (!m_reply || !m_device)
 	{
 		return;
 	}
@@ -348,12 +369,44 @@ void Transfer::downloadData()
 
 		if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid() && m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
 		{
+			m_bufferedBytes = 0;
+
+			m_device->resize(0);
 			m_device->reset();
 		}
 	}
 
-	m_device->write(m_reply->readAll());
-	m_device->seek(m_device->size());
+	if (m_buffer.size() != TRANSFER_BUFFER_SIZE)
+	{
+		m_buffer.resize(TRANSFER_BUFFER_SIZE);
+	}
+
+	while (m_reply->bytesAvailable() > 0)
+	{
+		const qint64 bytesRead(m_reply->read((m_buffer.data() + m_bufferedBytes), (m_buffer.size() - m_bufferedBytes)));
+
+		if (bytesRead <= 0)
+		{
+			break;
+		}
+
+		m_bufferedBytes += bytesRead;
+
+		if (m_bufferedBytes == m_buffer.size())
+		{
+			flushData();
+		}
+	}
+}
+
+void Transfer::flushData()
+{
+	if (m_bufferedBytes > 0 && m_device)
+	{
+		m_device->write(m_buffer.constData(), m_bufferedBytes);
+
+		m_bufferedBytes = 0;
+	}
 }
 
 void Transfer::downloadFinished()
@@ -384,14 +437,11 @@ void Transfer::downloadFinished()
 		return;
 	}
 
-	if (m_updateTimer != 0)
-	{
-		killTimer(m_updateTimer);
+	flushData();
 
-		m_updateTimer = 0;
-	}
+	m_buffer.clear();
 
-	if (m_reply->size() > 0)
+	if (m_device && m_reply->bytesAvailable() > 0)
 	{
 		m_device->write(m_reply->readAll());
 	}
@@ -400,6 +450,18 @@ void Transfer::downloadFinished()
 	disconnect(m_reply, SIGNAL(readyRead()), this, SLOT(downloadData()));
 	disconnect(m_reply, SIGNAL(finished()), this, SLOT(downloadFinished()));
 
+	finishTransfer();
+}
+
+void Transfer::finishTransfer()
+{
+	if (m_updateTimer != 0)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+	}
+
 	m_bytesReceived = (m_device ? m_device->size() : -1);
 
 	if (m_bytesTotal <= 0 && m_bytesReceived > 0)
@@ -459,6 +521,342 @@ void Transfer::downloadError(QNetworkReply::NetworkError error)
 	}
 }
 
+void Transfer::startSegments()
+{
+	if (!m_segments.isEmpty() || !m_reply || !m_device || m_state != RunningState || m_bytesStart > 0 || m_device->inherits(QStringLiteral("QTemporaryFile").toLatin1()))
+	{
+		return;
+	}
+
+	const int amount(qMin(SettingsManager::getValue(QLatin1String("Network/TransferSegmentsAmount")).toInt(), 16));
+	const qint64 bytesTotal(m_reply->header(QNetworkRequest::ContentLengthHeader).toLongLong());
+
+	if (amount < 2 || bytesTotal < (TRANSFER_SEGMENT_MINIMUM_SIZE * 2) || m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200 || m_reply->rawHeader(QByteArray("Accept-Ranges")).trimmed().toLower() != QByteArray("bytes"))
+	{
+		return;
+	}
+
+	downloadData();
+	flushData();
+
+	const qint64 segmentSize(qMax(qint64(TRANSFER_SEGMENT_MINIMUM_SIZE), (bytesTotal / amount)));
+	const qint64 position(m_device->pos());
+
+	if ((position + TRANSFER_SEGMENT_MINIMUM_SIZE) >= segmentSize)
+	{
+		return;
+	}
+
+	disconnect(m_reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(downloadProgress(qint64,qint64)));
+	disconnect(m_reply, SIGNAL(readyRead()), this, SLOT(downloadData()));
+	disconnect(m_reply, SIGNAL(finished()), this, SLOT(downloadFinished()));
+	disconnect(m_reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(downloadError(QNetworkReply::NetworkError)));
+	disconnect(m_reply, SIGNAL(metaDataChanged()), this, SLOT(startSegments()));
+
+	if (!m_device->resize(bytesTotal))
+	{
+		connect(m_reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(downloadProgress(qint64,qint64)));
+		connect(m_reply, SIGNAL(readyRead()), this, SLOT(downloadData()));
+		connect(m_reply, SIGNAL(finished()), this, SLOT(downloadFinished()));
+		connect(m_reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(downloadError(QNetworkReply::NetworkError)));
+
+		return;
+	}
+
+	m_bytesReceived = position;
+	m_bytesTotal = bytesTotal;
+
+	TransferSegment *primarySegment(new TransferSegment());
+	primarySegment->reply = m_reply;
+	primarySegment->position = position;
+	primarySegment->end = segmentSize;
+	primarySegment->isRanged = false;
+
+	m_segments.append(primarySegment);
+
+	connect(m_reply, SIGNAL(readyRead()), this, SLOT(segmentData()));
+	connect(m_reply, SIGNAL(finished()), this, SLOT(segmentFinished()));
+
+	m_reply = NULL;
+
+	for (qint64 start = segmentSize; start < bytesTotal; start += segmentSize)
+	{
+		TransferSegment *segment(new TransferSegment());
+		segment->position = start;
+		segment->end = (((bytesTotal - start) < (segmentSize * 2)) ? bytesTotal : (start + segmentSize));
+
+		m_segments.append(segment);
+
+		requestSegment(segment);
+
+		if (segment->end == bytesTotal)
+		{
+			break;
+		}
+	}
+
+	segmentData();
+}
+
+void Transfer::requestSegment(TransferSegment *segment)
+{
+	QNetworkRequest request;
+	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+	request.setRawHeader(QByteArray("Range"), QStringLiteral("bytes=%1-%2").arg(segment->position).arg(segment->end - 1).toLatin1());
+	request.setUrl(m_source);
+
+	segment->reply = NetworkManagerFactory::getNetworkManager()->get(request);
+	segment->reply->setReadBufferSize(TRANSFER_READ_BUFFER_SIZE);
+	segment->isRanged = true;
+
+	connect(segment->reply, SIGNAL(readyRead()), this, SLOT(segmentData()));
+	connect(segment->reply, SIGNAL(finished()), this, SLOT(segmentFinished()));
+}
+
+void Transfer::segmentData()
+{
+	readSegments();
+}
+
+bool Transfer::readSegments()
+{
+	if (!m_device)
+	{
+		return false;
+	}
+
+	if (m_buffer.size() != TRANSFER_BUFFER_SIZE)
+	{
+		m_buffer.resize(TRANSFER_BUFFER_SIZE);
+	}
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		TransferSegment *segment(m_segments.at(i));
+
+		if (!segment->reply || segment->reply->bytesAvailable() <= 0)
+		{
+			continue;
+		}
+
+		if (segment->isRanged && segment->reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
+		{
+			resumeWithoutSegments();
+
+			return false;
+		}
+
+		while (segment->position < segment->end && segment->reply->bytesAvailable() > 0)
+		{
+			const qint64 bytesRead(segment->reply->read(m_buffer.data(), qMin(qint64(m_buffer.size()), (segment->end - segment->position))));
+
+			if (bytesRead <= 0)
+			{
+				break;
+			}
+
+			if (!m_device->seek(segment->position) || m_device->write(m_buffer.constData(), bytesRead) != bytesRead)
+			{
+				Console::addMessage(tr("Failed to write transfer data to file: %1").arg(m_device->errorString()), OtherMessageCategory, ErrorMessageLevel, m_target);
+
+				stop();
+
+				return false;
+			}
+
+			segment->position += bytesRead;
+
+			m_bytesReceived += bytesRead;
+			m_bytesReceivedDifference += bytesRead;
+		}
+
+		if (segment->position >= segment->end && !finishSegment(segment))
+		{
+			return false;
+		}
+	}
+
+	emit progressChanged(m_bytesReceived, m_bytesTotal);
+
+	return true;
+}
+
+void Transfer::segmentFinished()
+{
+	QNetworkReply *reply(qobject_cast<QNetworkReply*>(sender()));
+
+	if (!getSegment(reply) || !readSegments())
+	{
+		return;
+	}
+
+	TransferSegment *segment(getSegment(reply));
+
+	if (!segment)
+	{
+		return;
+	}
+
+	if (segment->isRanged && segment->reply && segment->reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
+	{
+		resumeWithoutSegments();
+
+		return;
+	}
+
+	if (segment->reply && segment->position < segment->end)
+	{
+		segment->reply->disconnect(this);
+		segment->reply->deleteLater();
+		segment->reply = NULL;
+
+		if (segment->retries >= TRANSFER_SEGMENT_RETRIES)
+		{
+			stop();
+
+			return;
+		}
+
+		++segment->retries;
+
+		requestSegment(segment);
+	}
+}
+
+bool Transfer::finishSegment(TransferSegment *segment)
+{
+	if (segment->reply)
+	{
+		segment->reply->disconnect(this);
+
+		if (!segment->reply->isFinished())
+		{
+			segment->reply->abort();
+		}
+
+		segment->reply->deleteLater();
+		segment->reply = NULL;
+	}
+
+	TransferSegment *slowestSegment(NULL);
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (m_segments.at(i)->reply && (!slowestSegment || (m_segments.at(i)->end - m_segments.at(i)->position) > (slowestSegment->end - slowestSegment->position)))
+		{
+			slowestSegment = m_segments.at(i);
+		}
+	}
+
+	if (!slowestSegment)
+	{
+		m_buffer.clear();
+
+		qDeleteAll(m_segments);
+
+		m_segments.clear();
+
+		finishTransfer();
+
+		return false;
+	}
+
+	const qint64 remainingBytes(slowestSegment->end - slowestSegment->position);
+
+	if (remainingBytes < (TRANSFER_SEGMENT_MINIMUM_SIZE * 2))
+	{
+		return true;
+	}
+
+	segment->position = (slowestSegment->position + (remainingBytes / 2));
+	segment->end = slowestSegment->end;
+	segment->retries = 0;
+
+	slowestSegment->end = segment->position;
+
+	requestSegment(segment);
+
+	return true;
+}
+
+void Transfer::stopSegments()
+{
+	if (m_segments.isEmpty())
+	{
+		return;
+	}
+
+	qint64 completedBytes(m_bytesTotal);
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		TransferSegment *segment(m_segments.at(i));
+
+		if (segment->position < segment->end)
+		{
+			completedBytes = qMin(completedBytes, segment->position);
+		}
+
+		if (segment->reply)
+		{
+			segment->reply->disconnect(this);
+			segment->reply->abort();
+
+			QTimer::singleShot(250, segment->reply, SLOT(deleteLater()));
+		}
+	}
+
+	qDeleteAll(m_segments);
+
+	m_segments.clear();
+
+	if (m_device)
+	{
+		m_device->resize(completedBytes);
+		m_device->seek(completedBytes);
+	}
+
+	m_bytesReceived = completedBytes;
+}
+
+void Transfer::resumeWithoutSegments()
+{
+	stopSegments();
+
+	if (m_device)
+	{
+		m_device->close();
+		m_device->deleteLater();
+		m_device = NULL;
+	}
+
+	m_state = ErrorState;
+
+	if (!resume())
+	{
+		stop();
+	}
+}
+
+Transfer::TransferSegment* Transfer::getSegment(QNetworkReply *reply) const
+{
+	if (!reply)
+	{
+		return NULL;
+	}
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (m_segments.at(i)->reply == reply)
+		{
+			return m_segments.at(i);
+		}
+	}
+
+	return NULL;
+}
+
 void Transfer::markStarted()
 {
 	m_timeStarted = QDateTime::currentDateTime();
@@ -485,6 +883,10 @@ void Transfer::cancel()
 		QTimer::singleShot(250, m_reply, SLOT(deleteLater()));
 	}
 
+	m_bufferedBytes = 0;
+
+	stopSegments();
+
 	if (m_device)
 	{
 		m_device->remove();
@@ -500,6 +902,8 @@ void Transfer::cancel()
 
 void Transfer::stop()
 {
+	stopSegments();
+
 	if (m_updateTimer != 0)
 	{
 		killTimer(m_updateTimer);
@@ -514,6 +918,10 @@ void Transfer::stop()
 		QTimer::singleShot(250, m_reply, SLOT(deleteLater()));
 	}
 
+	flushData();
+
+	m_buffer.clear();
+
 	if (m_device && !m_device->inherits(QStringLiteral("QTemporaryFile").toLatin1()))
 	{
 		m_device->close();
@@ -720,6 +1128,7 @@ bool Transfer::resume()
 	request.setUrl(m_source);
 
 	m_reply = NetworkManagerFactory::getNetworkManager()->get(request);
+	m_reply->setReadBufferSize(TRANSFER_READ_BUFFER_SIZE);
 
 	downloadData();
 
@@ -761,6 +1170,7 @@ bool Transfer::restart()
 	request.setUrl(QUrl(m_source));
 
 	m_reply = NetworkManagerFactory::getNetworkManager()->get(request);
+	m_reply->setReadBufferSize(TRANSFER_READ_BUFFER_SIZE);
 
 	downloadData();
 
@@ -779,7 +1189,7 @@ bool Transfer::restart()
 
 bool Transfer::setTarget(const QString &target)
 {
-	if (m_target == target)
+	if (m_target == target || !m_segments.isEmpty())
 	{
 		return false;
 	}
@@ -854,6 +1264,8 @@ bool Transfer::setTarget(const QString &target)
 			disconnect(m_reply, SIGNAL(readyRead()), this, SLOT(downloadData()));
 		}
 
+		flushData();
+
 		m_device->reset();
 
 		file->write(m_device->readAll());
@@ -879,7 +1291,8 @@ bool Transfer::setTarget(const QString &target)
 }
 
 TransfersManager::TransfersManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+	m_saveTimer(0),
+	m_checkpointTimer(0)
 {
 }
 
@@ -893,12 +1306,8 @@ void TransfersManager::createInstance(QObject *parent)
 
 void TransfersManager::timerEvent(QTimerEvent *event)
 {
-	if (event->timerId() == m_saveTimer)
+	if (event->timerId() == m_saveTimer || event->timerId() == m_checkpointTimer)
 	{
-		killTimer(m_saveTimer);
-
-		m_saveTimer = 0;
-
 		save();
 	}
 }
@@ -911,6 +1320,21 @@ void TransfersManager::scheduleSave()
 	}
 }
 
+void TransfersManager::scheduleCheckpoint()
+{
+	if (m_checkpointTimer != 0 || m_saveTimer != 0)
+	{
+		return;
+	}
+
+	const int interval(SettingsManager::getValue(QLatin1String("History/DownloadsCheckpointInterval")).toInt());
+
+	if (interval > 0)
+	{
+		m_checkpointTimer = startTimer(interval * 1000);
+	}
+}
+
 void TransfersManager::addTransfer(Transfer *transfer)
 {
 	m_transfers.append(transfer);
@@ -940,11 +1364,30 @@ void TransfersManager::addTransfer(Transfer *transfer)
 
 void TransfersManager::save()
 {
+	if (m_saveTimer != 0)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+	}
+
+	if (m_checkpointTimer != 0)
+	{
+		killTimer(m_checkpointTimer);
+
+		m_checkpointTimer = 0;
+	}
+
 	if (SessionsManager::isReadOnly() || SettingsManager::getValue(QLatin1String("Browser/PrivateMode")).toBool() || !SettingsManager::getValue(QLatin1String("History/RememberDownloads")).toBool())
 	{
 		return;
 	}
 
+	if (!m_isInitilized)
+	{
+		getTransfers();
+	}
+
 	QSettings history(SessionsManager::getWritableDataPath(QLatin1String("transfers.ini")), QSettings::IniFormat);
 	history.clear();
 
@@ -965,6 +1408,8 @@ void TransfersManager::save()
 		history.setValue(QStringLiteral("%1/bytesTotal").arg(entry), m_transfers.at(i)->getBytesTotal());
 		history.setValue(QStringLiteral("%1/bytesReceived").arg(entry), m_transfers.at(i)->getBytesReceived());
 
+		m_savedStates[m_transfers.at(i)] = qMakePair(m_transfers.at(i)->getState(), m_transfers.at(i)->getTarget());
+
 		++entry;
 	}
 
@@ -1011,7 +1456,19 @@ void TransfersManager::transferChanged()
 	{
 		emit transferChanged(transfer);
 
-		scheduleSave();
+		if (m_privateTransfers.contains(transfer))
+		{
+			return;
+		}
+
+		if (m_savedStates.contains(transfer) && m_savedStates[transfer].first == transfer->getState() && m_savedStates[transfer].second == transfer->getTarget())
+		{
+			scheduleCheckpoint();
+		}
+		else
+		{
+			scheduleSave();
+		}
 	}
 }
 
@@ -1097,8 +1554,12 @@ QList<Transfer*> TransfersManager::getTransfers()
 	{
 		QSettings history(SessionsManager::getWritableDataPath(QLatin1String("transfers.ini")), QSettings::IniFormat);
 		const QStringList entries(history.childGroups());
+		const QList<Transfer*> currentTransfers(m_transfers);
+
+		m_isInitilized = true;
 
-		m_transfers.reserve(entries.count());
+		m_transfers.clear();
+		m_transfers.reserve(entries.count() + currentTransfers.count());
 
 		for (int i = 0; i < entries.count(); ++i)
 		{
@@ -1106,13 +1567,17 @@ QList<Transfer*> TransfersManager::getTransfers()
 
 			if (!history.value(QLatin1String("source")).toString().isEmpty() && !history.value(QLatin1String("target")).toString().isEmpty())
 			{
-				addTransfer(new Transfer(history, m_instance));
+				Transfer *transfer(new Transfer(history, m_instance));
+
+				addTransfer(transfer);
+
+				m_instance->m_savedStates[transfer] = qMakePair(transfer->getState(), transfer->getTarget());
 			}
 
 			history.endGroup();
 		}
 
-		m_isInitilized = true;
+		m_transfers.append(currentTransfers);
 
 		connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), m_instance, SLOT(save()));
 	}
@@ -1131,6 +1596,9 @@ bool TransfersManager::removeTransfer(Transfer *transfer, bool keepFile)
 
 	m_privateTransfers.removeAll(transfer);
 
+	m_instance->m_savedStates.remove(transfer);
+	m_instance->scheduleSave();
+
 	if (transfer->getState() == Transfer::RunningState)
 	{
 		transfer->stop();
@@ -89,14 +89,36 @@ public slots:
 	virtual bool setTarget(const QString &target);
 
 protected:
+	struct TransferSegment
+	{
+		QPointer<QNetworkReply> reply;
+		qint64 position;
+		qint64 end;
+		int retries;
+		bool isRanged;
+
+		TransferSegment() : position(0), end(0), retries(0), isRanged(true) {}
+	};
+
 	void timerEvent(QTimerEvent *event);
 	void start(QNetworkReply *reply, const QString &target);
+	void flushData();
+	void finishTransfer();
+	void requestSegment(TransferSegment *segment);
+	bool readSegments();
+	bool finishSegment(TransferSegment *segment);
+	void stopSegments();
+	void resumeWithoutSegments();
+	TransferSegment* getSegment(QNetworkReply *reply) const;
 
 protected slots:
 	void downloadProgress(qint64 bytesReceived, qint64 bytesTotal);
 	void downloadData();
 	void downloadFinished();
 	void downloadError(QNetworkReply::NetworkError error);
+	void segmentData();
+	void segmentFinished();
+	void startSegments();
 	void markStarted();
 	void markFinished(bool reset = false);
 
@@ -110,11 +132,14 @@ private:
 	QDateTime m_timeStarted;
 	QDateTime m_timeFinished;
 	QMimeType m_mimeType;
+	QByteArray m_buffer;
+	QList<TransferSegment*> m_segments;
 	qint64 m_speed;
 	qint64 m_bytesStart;
 	qint64 m_bytesReceivedDifference;
 	qint64 m_bytesReceived;
 	qint64 m_bytesTotal;
+	qint64 m_bufferedBytes;
 	TransferOptions m_options;
 	TransferState m_state;
 	int m_updateTimer;
@@ -150,6 +175,7 @@ protected:
 
 	void timerEvent(QTimerEvent *event);
 	void scheduleSave();
+	void scheduleCheckpoint();
 
 protected slots:
 	void save();
@@ -159,7 +185,9 @@ protected slots:
 	void transferStopped();
 
 private:
+	QHash<Transfer*, QPair<Transfer::TransferState, QString> > m_savedStates;
 	int m_saveTimer;
+	int m_checkpointTimer;
 
 	static TransfersManager *m_instance;
 	static QList<Transfer*> m_transfers;
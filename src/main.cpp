@@ -21,6 +21,7 @@
 #include "core/Application.h"
 #include "core/SessionsManager.h"
 #include "core/SettingsManager.h"
+#include "core/StartupTrace.h"
 #include "ui/MainWindow.h"
 #include "ui/StartupDialog.h"
 
@@ -68,7 +69,7 @@ int main(int argc, char *argv[])
 	Application application(argc, argv);
 	application.setAttribute(Qt::AA_UseHighDpiPixmaps, true);
 
-	if (application.isRunning() || application.isUpdating() || application.getCommandLineParser()->isSet(QLatin1String("report")))
+	if (application.isRunning() || application.isUpdating() || application.getCommandLineParser()->isSet(QLatin1String("report")) || application.getCommandLineParser()->isSet(QLatin1String("content-blocking-benchmark")))
 	{
 		return 0;
 	}
@@ -77,6 +78,8 @@ int main(int argc, char *argv[])
 	const QString startupBehavior(SettingsManager::getValue(QLatin1String("Browser/StartupBehavior")).toString());
 	const bool isPrivate(application.getCommandLineParser()->isSet(QLatin1String("privatesession")));
 
+	StartupTrace::beginEvent(QLatin1String("restoreSession"));
+
 	if (!application.getCommandLineParser()->value(QLatin1String("session")).isEmpty() && SessionsManager::getSession(session).isClean)
 	{
 		SessionsManager::restoreSession(SessionsManager::getSession(session), NULL, isPrivate);
@@ -129,6 +132,8 @@ int main(int argc, char *argv[])
 		SessionsManager::restoreSession(sessionData, NULL, isPrivate);
 	}
 
+	StartupTrace::endEvent();
+
 	if (!application.getCommandLineParser()->positionalArguments().isEmpty())
 	{
 		MainWindow *window(application.getWindow());
@@ -27,58 +27,143 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTimer>
 
+#define QTWEBENGINEURLREQUESTINTERCEPTOR_SNAPSHOT_GRACE_PERIOD 5000
+
 namespace Otter
 {
 
 QtWebEngineUrlRequestInterceptor::QtWebEngineUrlRequestInterceptor(QObject *parent) : QWebEngineUrlRequestInterceptor(parent),
-	m_areImagesEnabled(SettingsManager::getValue(QLatin1String("Browser/EnableImages")).toString() != QLatin1String("disabled"))
+	m_snapshot(NULL),
+	m_pendingBlockedElements(NULL)
 {
+	publishSnapshot();
+
 	QTimer::singleShot(1800000, this, SLOT(clearContentBlockingInformation()));
 
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString)));
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant,QUrl)), this, SLOT(optionChanged(QString)));
+	connect(ContentBlockingManager::getInstance(), SIGNAL(profileModified(QString)), this, SLOT(publishSnapshot()));
+}
+
+QtWebEngineUrlRequestInterceptor::~QtWebEngineUrlRequestInterceptor()
+{
+	qDeleteAll(m_retiredSnapshots);
+
+	delete m_snapshot.fetchAndStoreAcquire(NULL);
+
+	BlockedElement *element(m_pendingBlockedElements.fetchAndStoreAcquire(NULL));
+
+	while (element)
+	{
+		BlockedElement *next(element->next);
+
+		delete element;
+
+		element = next;
+	}
 }
 
 void QtWebEngineUrlRequestInterceptor::optionChanged(const QString &option)
 {
-	if (option == QLatin1String("Browser/EnableImages"))
+	if (option == QLatin1String("Browser/EnableImages") || option == QLatin1String("Content/BlockingProfiles"))
+	{
+		publishSnapshot();
+	}
+}
+
+void QtWebEngineUrlRequestInterceptor::publishSnapshot()
+{
+	ContentBlockingSnapshot *snapshot(new ContentBlockingSnapshot());
+	snapshot->defaultProfiles = ContentBlockingManager::getProfileList(SettingsManager::getValue(QLatin1String("Content/BlockingProfiles")).toStringList());
+	snapshot->areImagesEnabled = (SettingsManager::getValue(QLatin1String("Browser/EnableImages")).toString() != QLatin1String("disabled"));
+
+	const QStringList hosts(SettingsManager::getOverrideHosts(QLatin1String("Content/BlockingProfiles")));
+
+	for (int i = 0; i < hosts.count(); ++i)
+	{
+		const QUrl url(QLatin1String("http://") + hosts.at(i) + QLatin1Char('/'));
+
+		snapshot->hostProfiles[hosts.at(i)] = ContentBlockingManager::getProfileList(SettingsManager::getValue(QLatin1String("Content/BlockingProfiles"), url).toStringList());
+	}
+
+	const ContentBlockingSnapshot *previousSnapshot(m_snapshot.fetchAndStoreOrdered(snapshot));
+
+	if (previousSnapshot)
 	{
-		m_areImagesEnabled = (SettingsManager::getValue(QLatin1String("Browser/EnableImages")).toString() != QLatin1String("disabled"));
+		m_retiredSnapshots.append(previousSnapshot);
+
+		QTimer::singleShot(QTWEBENGINEURLREQUESTINTERCEPTOR_SNAPSHOT_GRACE_PERIOD, this, SLOT(deleteRetiredSnapshot()));
 	}
-	else if (option == QLatin1String("Content/BlockingProfiles"))
+}
+
+void QtWebEngineUrlRequestInterceptor::deleteRetiredSnapshot()
+{
+	if (!m_retiredSnapshots.isEmpty())
 	{
-		clearContentBlockingInformation();
+		delete m_retiredSnapshots.takeFirst();
+	}
+}
+
+void QtWebEngineUrlRequestInterceptor::processBlockedElements()
+{
+	BlockedElement *element(m_pendingBlockedElements.fetchAndStoreAcquire(NULL));
+	BlockedElement *reversedElement(NULL);
+
+	while (element)
+	{
+		BlockedElement *next(element->next);
+
+		element->next = reversedElement;
+		reversedElement = element;
+		element = next;
+	}
+
+	while (reversedElement)
+	{
+		BlockedElement *next(reversedElement->next);
+
+		if (!m_blockedElements.value(reversedElement->domain).contains(reversedElement->url))
+		{
+			m_blockedElements[reversedElement->domain].append(reversedElement->url);
+		}
+
+		delete reversedElement;
+
+		reversedElement = next;
 	}
 }
 
 void QtWebEngineUrlRequestInterceptor::clearContentBlockingInformation()
 {
+	processBlockedElements();
+
 	m_blockedElements.clear();
-	m_contentBlockingProfiles.clear();
+
+	publishSnapshot();
 
 	QTimer::singleShot(1800000, this, SLOT(clearContentBlockingInformation()));
 }
 
-QStringList QtWebEngineUrlRequestInterceptor::getBlockedElements(const QString &domain) const
+QStringList QtWebEngineUrlRequestInterceptor::getBlockedElements(const QString &domain)
 {
+	processBlockedElements();
+
 	return m_blockedElements.value(domain);
 }
 
 void QtWebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo &request)
 {
-	if (!m_areImagesEnabled && request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeImage)
+	const ContentBlockingSnapshot *snapshot(m_snapshot.loadAcquire());
+
+	if (!snapshot->areImagesEnabled && request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeImage)
 	{
 		request.block(true);
 
 		return;
 	}
 
-	if (!m_contentBlockingProfiles.contains(request.firstPartyUrl().host()))
-	{
-		m_contentBlockingProfiles[request.firstPartyUrl().host()] = ContentBlockingManager::getProfileList(SettingsManager::getValue(QLatin1String("Content/BlockingProfiles"), request.firstPartyUrl()).toStringList());
-	}
-
-	const QVector<int> contentBlockingProfiles(m_contentBlockingProfiles.value(request.firstPartyUrl().host()));
+	const QString host(request.firstPartyUrl().isLocalFile() ? QString(QLatin1String("localhost")) : request.firstPartyUrl().host());
+	const QVector<int> contentBlockingProfiles(snapshot->hostProfiles.value(host, snapshot->defaultProfiles));
 
 	if (contentBlockingProfiles.isEmpty())
 	{
@@ -136,6 +221,13 @@ void QtWebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo
 
 			break;
 		default:
+			resourceType = NetworkManager::getResourceType(request.requestUrl());
+
+			if (resourceType == NetworkManager::ScriptType || resourceType == NetworkManager::StyleSheetType)
+			{
+				storeBlockedUrl = false;
+			}
+
 			break;
 	}
 
@@ -143,9 +235,24 @@ void QtWebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo
 
 	if (result.isBlocked)
 	{
-		if (storeBlockedUrl && !m_blockedElements.value(request.firstPartyUrl().host()).contains(request.requestUrl().url()))
+		if (storeBlockedUrl)
 		{
-			m_blockedElements[request.firstPartyUrl().host()].append(request.requestUrl().url());
+			BlockedElement *element(new BlockedElement());
+			element->domain = request.firstPartyUrl().host();
+			element->url = request.requestUrl().url();
+
+			BlockedElement *head(m_pendingBlockedElements.loadAcquire());
+
+			do
+			{
+				element->next = head;
+			}
+			while (!m_pendingBlockedElements.testAndSetOrdered(head, element, head));
+
+			if (!head)
+			{
+				QMetaObject::invokeMethod(this, "processBlockedElements", Qt::QueuedConnection);
+			}
 		}
 
 		Console::addMessage(QCoreApplication::translate("main", "Blocked request"), Otter::NetworkMessageCategory, LogMessageLevel, request.requestUrl().toString(), -1);
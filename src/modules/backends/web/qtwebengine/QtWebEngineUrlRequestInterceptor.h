@@ -21,6 +21,8 @@
 #ifndef OTTER_QTWEBENGINEURLREQUESTINTERCEPTOR_H
 #define OTTER_QTWEBENGINEURLREQUESTINTERCEPTOR_H
 
+#include <QtCore/QAtomicPointer>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
 #include <QtCore/QVector>
 #include <QtWebEngineCore/QWebEngineUrlRequestInterceptor>
@@ -34,18 +36,40 @@ class QtWebEngineUrlRequestInterceptor : public QWebEngineUrlRequestInterceptor
 
 public:
 	explicit QtWebEngineUrlRequestInterceptor(QObject *parent = NULL);
+	~QtWebEngineUrlRequestInterceptor();
 
-	QStringList getBlockedElements(const QString &domain) const;
+	QStringList getBlockedElements(const QString &domain);
 	void interceptRequest(QWebEngineUrlRequestInfo &request);
 
+protected:
+	struct ContentBlockingSnapshot
+	{
+		QHash<QString, QVector<int> > hostProfiles;
+		QVector<int> defaultProfiles;
+		bool areImagesEnabled;
+
+		ContentBlockingSnapshot() : areImagesEnabled(true) {}
+	};
+
+	struct BlockedElement
+	{
+		QString domain;
+		QString url;
+		BlockedElement *next;
+	};
+
 protected slots:
 	void optionChanged(const QString &option);
+	void publishSnapshot();
+	void deleteRetiredSnapshot();
 	void clearContentBlockingInformation();
+	void processBlockedElements();
 
 private:
 	QMap<QString, QStringList> m_blockedElements;
-	QMap<QString, QVector<int> > m_contentBlockingProfiles;
-	bool m_areImagesEnabled;
+	QVector<const ContentBlockingSnapshot*> m_retiredSnapshots;
+	QAtomicPointer<const ContentBlockingSnapshot> m_snapshot;
+	QAtomicPointer<BlockedElement> m_pendingBlockedElements;
 };
 
 }
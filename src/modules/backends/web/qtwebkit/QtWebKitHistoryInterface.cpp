@@ -19,38 +19,298 @@
 
 #include "QtWebKitHistoryInterface.h"
 #include "../../../../core/HistoryManager.h"
+#include "../../../../core/SessionsManager.h"
+#include "../../../../core/SettingsManager.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimerEvent>
+
+#define VISITED_LINKS_VERSION 2
 
 namespace Otter
 {
 
-QtWebKitHistoryInterface::QtWebKitHistoryInterface(QObject *parent) : QWebHistoryInterface(parent)
+QtWebKitHistoryInterface::QtWebKitHistoryInterface(QObject *parent) : QWebHistoryInterface(parent),
+	m_amount(0),
+	m_rebuildTimer(0),
+	m_isModified(false)
+{
+	HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+
+	if (!load(getStamp()))
+	{
+		rebuild();
+	}
+
+	connect(model, SIGNAL(cleared()), this, SLOT(clear()));
+	connect(model, SIGNAL(entryAdded(HistoryEntryItem*)), this, SLOT(entryAdded(HistoryEntryItem*)));
+	connect(model, SIGNAL(entryModified(HistoryEntryItem*)), this, SLOT(entryAdded(HistoryEntryItem*)));
+	connect(model, SIGNAL(entryRemoved(HistoryEntryItem*)), this, SLOT(scheduleRebuild()));
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString)));
+	connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), this, SLOT(save()));
+}
+
+void QtWebKitHistoryInterface::timerEvent(QTimerEvent *event)
 {
-	connect(HistoryManager::getBrowsingHistoryModel(), SIGNAL(cleared()), this, SLOT(clear()));
+	if (event->timerId() == m_rebuildTimer)
+	{
+		killTimer(m_rebuildTimer);
+
+		m_rebuildTimer = 0;
+
+		rebuild();
+	}
+}
+
+void QtWebKitHistoryInterface::optionChanged(const QString &option)
+{
+	if (option == QLatin1String("History/RememberBrowsing") || option == QLatin1String("Browser/PrivateMode"))
+	{
+		scheduleRebuild();
+	}
 }
 
 void QtWebKitHistoryInterface::clear()
 {
-	m_urls.clear();
+	m_hashes.clear();
+	m_sessionHashes.clear();
+
+	m_amount = 0;
+	m_isModified = true;
 }
 
-void QtWebKitHistoryInterface::addHistoryEntry(const QString &url)
+void QtWebKitHistoryInterface::save()
 {
-	if (m_urls.contains(url))
+	if (!m_isModified || SessionsManager::isReadOnly())
+	{
+		return;
+	}
+
+	const QString path(SessionsManager::getWritableDataPath(QLatin1String("visitedLinks.dat")));
+
+	if (!HistoryManager::isEnabled())
+	{
+		QFile::remove(path);
+
+		return;
+	}
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
 	{
 		return;
 	}
 
-	m_urls.append(url);
+	QVector<quint64> hashes(m_hashes);
+	int amount(m_amount);
 
-	if (m_urls.length() > 100)
+	if (!m_sessionHashes.isEmpty())
 	{
-		m_urls.removeAt(0);
+		hashes.clear();
+		amount = 0;
+
+		for (int i = 0; i < m_hashes.count(); ++i)
+		{
+			if (m_hashes.at(i) != 0 && !m_sessionHashes.contains(m_hashes.at(i)))
+			{
+				insertHash(hashes, amount, m_hashes.at(i));
+			}
+		}
+	}
+
+	QDataStream stream(&file);
+	stream << quint32(VISITED_LINKS_VERSION) << getStamp() << qint32(amount) << hashes;
+
+	if (file.commit())
+	{
+		m_isModified = false;
+	}
+}
+
+void QtWebKitHistoryInterface::rebuild()
+{
+	m_hashes.clear();
+	m_amount = 0;
+	m_isModified = true;
+
+	if (HistoryManager::isEnabled())
+	{
+		HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+
+		for (int i = 0; i < model->rowCount(); ++i)
+		{
+			insertHash(hashUrl(model->index(i, 0).data(HistoryModel::UrlRole).toUrl()));
+		}
+	}
+
+	QSet<quint64>::const_iterator iterator;
+
+	for (iterator = m_sessionHashes.constBegin(); iterator != m_sessionHashes.constEnd(); ++iterator)
+	{
+		insertHash(m_hashes, m_amount, *iterator);
 	}
 }
 
+void QtWebKitHistoryInterface::scheduleRebuild()
+{
+	if (m_rebuildTimer == 0)
+	{
+		m_rebuildTimer = startTimer(1000);
+	}
+}
+
+void QtWebKitHistoryInterface::entryAdded(HistoryEntryItem *entry)
+{
+	if (entry && HistoryManager::isEnabled())
+	{
+		insertHash(hashUrl(entry->data(HistoryModel::UrlRole).toUrl()));
+	}
+}
+
+void QtWebKitHistoryInterface::insertHash(quint64 hash)
+{
+	const bool isInserted(insertHash(m_hashes, m_amount, hash));
+
+	if (m_sessionHashes.remove(hash) || isInserted)
+	{
+		m_isModified = true;
+	}
+}
+
+void QtWebKitHistoryInterface::addHistoryEntry(const QString &url)
+{
+	const quint64 hash(hashUrl(QUrl(url)));
+
+	if (insertHash(m_hashes, m_amount, hash))
+	{
+		m_sessionHashes.insert(hash);
+	}
+}
+
+quint64 QtWebKitHistoryInterface::hashUrl(const QUrl &url)
+{
+	const QString normalizedUrl(url.adjusted(QUrl::RemoveFragment | QUrl::StripTrailingSlash).toString(QUrl::FullyEncoded));
+	const QChar *data(normalizedUrl.constData());
+	quint64 hash(Q_UINT64_C(14695981039346656037));
+
+	for (int i = 0; i < normalizedUrl.length(); ++i)
+	{
+		hash ^= data[i].unicode();
+		hash *= Q_UINT64_C(1099511628211);
+	}
+
+	return ((hash == 0) ? 1 : hash);
+}
+
+bool QtWebKitHistoryInterface::insertHash(QVector<quint64> &hashes, int &amount, quint64 hash)
+{
+	if (((amount + 1) * 2) > hashes.count())
+	{
+		const QVector<quint64> oldHashes(hashes);
+
+		hashes = QVector<quint64>(qMax(1024, (oldHashes.count() * 2)), 0);
+		amount = 0;
+
+		for (int i = 0; i < oldHashes.count(); ++i)
+		{
+			if (oldHashes.at(i) != 0)
+			{
+				insertHash(hashes, amount, oldHashes.at(i));
+			}
+		}
+	}
+
+	const int mask(hashes.count() - 1);
+	int position(hash & mask);
+
+	while (hashes.at(position) != 0)
+	{
+		if (hashes.at(position) == hash)
+		{
+			return false;
+		}
+
+		position = ((position + 1) & mask);
+	}
+
+	hashes[position] = hash;
+
+	++amount;
+
+	return true;
+}
+
+quint64 QtWebKitHistoryInterface::getStamp() const
+{
+	HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+
+	if (!model || model->rowCount() == 0)
+	{
+		return 0;
+	}
+
+	return ((quint64(model->rowCount()) << 44) ^ quint64(model->index(0, 0).data(HistoryModel::TimeVisitedRole).toDateTime().toMSecsSinceEpoch()));
+}
+
+bool QtWebKitHistoryInterface::load(quint64 stamp)
+{
+	if (!HistoryManager::isEnabled())
+	{
+		return false;
+	}
+
+	QFile file(SessionsManager::getWritableDataPath(QLatin1String("visitedLinks.dat")));
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	QVector<quint64> hashes;
+	quint64 savedStamp(0);
+	quint32 version(0);
+	qint32 amount(0);
+
+	stream >> version >> savedStamp >> amount >> hashes;
+
+	if (stream.status() != QDataStream::Ok || version != VISITED_LINKS_VERSION || savedStamp != stamp || hashes.isEmpty() || (hashes.count() & (hashes.count() - 1)) != 0 || amount >= hashes.count())
+	{
+		return false;
+	}
+
+	m_hashes = hashes;
+	m_amount = amount;
+
+	return true;
+}
+
 bool QtWebKitHistoryInterface::historyContains(const QString &url) const
 {
-	return (m_urls.contains(url) || HistoryManager::hasEntry(url));
+	if (m_hashes.isEmpty())
+	{
+		return false;
+	}
+
+	const quint64 hash(hashUrl(QUrl(url)));
+	const int mask(m_hashes.count() - 1);
+	int position(hash & mask);
+
+	while (m_hashes.at(position) != 0)
+	{
+		if (m_hashes.at(position) == hash)
+		{
+			return true;
+		}
+
+		position = ((position + 1) & mask);
+	}
+
+	return false;
 }
 
 }
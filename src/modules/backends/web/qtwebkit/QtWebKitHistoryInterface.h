@@ -20,12 +20,15 @@
 #ifndef OTTER_QTWEBKITHISTORYINTERFACE_H
 #define OTTER_QTWEBKITHISTORYINTERFACE_H
 
-#include <QtCore/QStringList>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
 #include <QtWebKit/QWebHistoryInterface>
 
 namespace Otter
 {
 
+class HistoryEntryItem;
+
 class QtWebKitHistoryInterface : public QWebHistoryInterface
 {
 	Q_OBJECT
@@ -36,11 +39,28 @@ public:
 	void addHistoryEntry(const QString &url);
 	bool historyContains(const QString &url) const;
 
+protected:
+	void timerEvent(QTimerEvent *event);
+	void insertHash(quint64 hash);
+	void rebuild();
+	quint64 getStamp() const;
+	bool load(quint64 stamp);
+	static quint64 hashUrl(const QUrl &url);
+	static bool insertHash(QVector<quint64> &hashes, int &amount, quint64 hash);
+
 protected slots:
 	void clear();
+	void save();
+	void optionChanged(const QString &option);
+	void entryAdded(HistoryEntryItem *entry);
+	void scheduleRebuild();
 
 private:
-	QStringList m_urls;
+	QVector<quint64> m_hashes;
+	QSet<quint64> m_sessionHashes;
+	int m_amount;
+	int m_rebuildTimer;
+	bool m_isModified;
 };
 
 }
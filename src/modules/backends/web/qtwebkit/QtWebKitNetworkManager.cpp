@@ -36,6 +36,7 @@
 #include "../../../../ui/ContentsDialog.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFileInfo>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
@@ -130,6 +131,7 @@ void QtWebKitNetworkManager::resetStatistics()
 	m_pageInformation.clear();
 	m_pageInformation[WebWidget::BytesReceivedInformation] = quint64(0);
 	m_pageInformation[WebWidget::BytesTotalInformation] = quint64(0);
+	m_pageInformation[WebWidget::RequestsBlockingTimeInformation] = qint64(0);
 	m_pageInformation[WebWidget::RequestsFinishedInformation] = 0;
 	m_pageInformation[WebWidget::RequestsStartedInformation] = 0;
 	m_baseReply = NULL;
@@ -575,66 +577,45 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(QNetworkAccessManager::Oper
 
 	if (m_contentBlockingExceptions.isEmpty() || !m_contentBlockingExceptions.contains(request.url()))
 	{
-		if (!m_areImagesEnabled && (request.rawHeader(QByteArray("Accept")).contains(QByteArray("image/")) || request.url().path().endsWith(QLatin1String(".png")) || request.url().path().endsWith(QLatin1String(".jpg")) || request.url().path().endsWith(QLatin1String(".gif"))))
+		const bool needsContentBlocking(!m_widget->isNavigating() && !m_contentBlockingProfiles.isEmpty());
+		NetworkManager::ResourceType resourceType(NetworkManager::OtherType);
+
+		if (!m_areImagesEnabled || needsContentBlocking)
+		{
+			resourceType = NetworkManager::getResourceType(request);
+		}
+
+		if (!m_areImagesEnabled && resourceType == NetworkManager::ImageType)
 		{
 			return QNetworkAccessManager::createRequest(QNetworkAccessManager::GetOperation, QNetworkRequest(QUrl()));
 		}
 
-		if (!m_widget->isNavigating())
+		if (needsContentBlocking)
 		{
-			if (!m_contentBlockingProfiles.isEmpty())
+			if (!m_baseReply)
 			{
-				const QByteArray acceptHeader(request.rawHeader(QByteArray("Accept")));
-				const QString path(request.url().path());
-				NetworkManager::ResourceType resourceType(NetworkManager::OtherType);
-				bool storeBlockedUrl(true);
-
-				if (!m_baseReply)
-				{
-					resourceType = NetworkManager::MainFrameType;
-				}
-				else if (acceptHeader.contains(QByteArray("text/html")) || acceptHeader.contains(QByteArray("application/xhtml+xml")) || acceptHeader.contains(QByteArray("application/xml")) || path.endsWith(QLatin1String(".htm")) || path.endsWith(QLatin1String(".html")))
-				{
-					resourceType = NetworkManager::SubFrameType;
-				}
-				else if (acceptHeader.contains(QByteArray("image/")) || path.endsWith(QLatin1String(".png")) || path.endsWith(QLatin1String(".jpg")) || path.endsWith(QLatin1String(".gif")))
-				{
-					resourceType = NetworkManager::ImageType;
-				}
-				else if (acceptHeader.contains(QByteArray("script/")) || path.endsWith(QLatin1String(".js")))
-				{
-					resourceType = NetworkManager::ScriptType;
-					storeBlockedUrl = false;
-				}
-				else if (acceptHeader.contains(QByteArray("text/css")) || path.endsWith(QLatin1String(".css")))
-				{
-					resourceType = NetworkManager::StyleSheetType;
-					storeBlockedUrl = false;
-				}
-				else if (acceptHeader.contains(QByteArray("object")))
-				{
-					resourceType = NetworkManager::ObjectType;
-				}
-				else if (request.rawHeader(QByteArray("X-Requested-With")) == QByteArray("XMLHttpRequest"))
-				{
-					resourceType = NetworkManager::XmlHttpRequestType;
-				}
+				resourceType = NetworkManager::MainFrameType;
+			}
 
-				const ContentBlockingManager::CheckResult result(ContentBlockingManager::checkUrl(m_contentBlockingProfiles, m_widget->getUrl(), request.url(), resourceType));
+			QElapsedTimer timer;
+			timer.start();
 
-				if (result.isBlocked)
-				{
-					Console::addMessage(QCoreApplication::translate("main", "Blocked request"), Otter::NetworkMessageCategory, LogMessageLevel, request.url().toString(), -1, (m_widget ? m_widget->getWindowIdentifier() : 0));
+			const ContentBlockingManager::CheckResult result(ContentBlockingManager::checkUrl(m_contentBlockingProfiles, m_widget->getUrl(), request.url(), resourceType));
 
-					if (storeBlockedUrl)
-					{
-						m_blockedElements.append(request.url().url());
-					}
+			m_pageInformation[WebWidget::RequestsBlockingTimeInformation] = (m_pageInformation[WebWidget::RequestsBlockingTimeInformation].toLongLong() + timer.nsecsElapsed());
 
-					m_blockedRequests.append(result);
+			if (result.isBlocked)
+			{
+				Console::addMessage(QCoreApplication::translate("main", "Blocked request"), Otter::NetworkMessageCategory, LogMessageLevel, request.url().toString(), -1, (m_widget ? m_widget->getWindowIdentifier() : 0));
 
-					return QNetworkAccessManager::createRequest(QNetworkAccessManager::GetOperation, QNetworkRequest(QUrl()));
+				if (resourceType != NetworkManager::ScriptType && resourceType != NetworkManager::StyleSheetType)
+				{
+					m_blockedElements.append(request.url().url());
 				}
+
+				m_blockedRequests.append(result);
+
+				return QNetworkAccessManager::createRequest(QNetworkAccessManager::GetOperation, QNetworkRequest(QUrl()));
 			}
 		}
 	}
@@ -20,6 +20,7 @@
 
 #include "QtWebKitPage.h"
 #include "QtWebKitNetworkManager.h"
+#include "QtWebKitWebBackend.h"
 #include "QtWebKitWebWidget.h"
 #include "../../../../core/Console.h"
 #include "../../../../core/ContentBlockingManager.h"
@@ -30,6 +31,7 @@
 #include "../../../../ui/ContentsDialog.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QSet>
 #include <QtGui/QDesktopServices>
 #include <QtGui/QGuiApplication>
 #include <QtGui/QWheelEvent>
@@ -41,9 +43,13 @@
 #include <QtWebKit/QWebElement>
 #include <QtWebKitWidgets/QWebFrame>
 
+#define QTWEBKITPAGE_STYLESHEETS_CACHE_SIZE 4194304
+
 namespace Otter
 {
 
+QCache<QString, QUrl> QtWebKitPage::m_styleSheets(QTWEBKITPAGE_STYLESHEETS_CACHE_SIZE);
+
 QtWebKitPage::QtWebKitPage(QtWebKitNetworkManager *networkManager, QtWebKitWebWidget *parent) : QWebPage(parent),
 	m_widget(parent),
 	m_networkManager(networkManager),
@@ -58,6 +64,11 @@ QtWebKitPage::QtWebKitPage(QtWebKitNetworkManager *networkManager, QtWebKitWebWi
 
 	connect(this, SIGNAL(loadFinished(bool)), this, SLOT(pageLoadFinished()));
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+
+	if (QtWebKitWebBackend::getInstance())
+	{
+		connect(QtWebKitWebBackend::getInstance(), SIGNAL(styleSheetsChanged()), this, SLOT(updateStyleSheets()));
+	}
 }
 
 QtWebKitPage::QtWebKitPage() : QWebPage(),
@@ -92,39 +103,29 @@ void QtWebKitPage::pageLoadFinished()
 
 	updateStyleSheets();
 
-	if (m_widget)
-	{
-		const QVector<int> profiles(ContentBlockingManager::getProfileList(m_widget->getOption(QLatin1String("Content/BlockingProfiles"), m_widget->getUrl()).toStringList()));
-
-		applyContentBlockingRules(ContentBlockingManager::getStyleSheet(profiles), true);
+	const QStringList blockedRequests(m_widget ? m_widget->getBlockedElements() : QStringList());
 
-		const QStringList domainList(ContentBlockingManager::createSubdomainList(m_widget->getUrl().host()));
+	if (!blockedRequests.isEmpty())
+	{
+		const QUrl::FormattingOptions options(QUrl::RemoveFragment | QUrl::NormalizePathSegments);
+		QSet<QUrl> blockedUrls;
+		blockedUrls.reserve(blockedRequests.count());
 
-		for (int i = 0; i < domainList.count(); ++i)
+		for (int i = 0; i < blockedRequests.count(); ++i)
 		{
-			applyContentBlockingRules(ContentBlockingManager::getStyleSheetBlackList(domainList.at(i), profiles), true);
-			applyContentBlockingRules(ContentBlockingManager::getStyleSheetWhiteList(domainList.at(i), profiles), false);
+			blockedUrls.insert(QUrl(blockedRequests.at(i)).adjusted(options));
 		}
-	}
 
-	const QStringList blockedRequests(m_widget->getBlockedElements());
-
-	if (blockedRequests.count() > 0)
-	{
+		const QUrl baseUrl(mainFrame()->baseUrl());
 		const QWebElementCollection elements(mainFrame()->documentElement().findAll(QLatin1String("[src]")));
 
-		for (int i = 0; i < blockedRequests.count(); ++i)
+		for (int i = 0; i < elements.count(); ++i)
 		{
-			for (int j = 0; j < elements.count(); ++j)
-			{
-				QWebElement element(elements.at(j));
-
-				if (element.attribute(QLatin1String("src")) == blockedRequests[i]) ///NOTE: Consider comparing them as URLs
-				{
-					element.setStyleProperty(QLatin1String("display"), QLatin1String("none !important"));
+			QWebElement element(elements.at(i));
 
-					break;
-				}
+			if (blockedUrls.contains(baseUrl.resolved(QUrl(element.attribute(QLatin1String("src")))).adjusted(options)))
+			{
+				element.setStyleProperty(QLatin1String("display"), QLatin1String("none !important"));
 			}
 		}
 	}
@@ -149,38 +150,15 @@ void QtWebKitPage::markAsPopup()
 	m_isPopup = true;
 }
 
-void QtWebKitPage::applyContentBlockingRules(const QStringList &rules, bool remove)
-{
-	const QWebElement document(mainFrame()->documentElement());
-	const QString value(remove ? QLatin1String("none !important") : QString());
-
-	for (int i = 0; i < rules.count(); ++i)
-	{
-		const QWebElementCollection elements(document.findAll(rules.at(i)));
-
-		for (int j = 0; j < elements.count(); ++j)
-		{
-			QWebElement element(elements.at(j));
-
-			if (!element.isNull())
-			{
-				element.setStyleProperty(QLatin1String("display"), value);
-			}
-		}
-	}
-}
-
 void QtWebKitPage::updateStyleSheets(const QUrl &url)
 {
 	const QUrl currentUrl(url.isEmpty() ? mainFrame()->url() : url);
-	QString styleSheet((QStringLiteral("html {color: %1;} a {color: %2;} a:visited {color: %3;}")).arg(SettingsManager::getValue(QLatin1String("Content/TextColor")).toString()).arg(SettingsManager::getValue(QLatin1String("Content/LinkColor")).toString()).arg(SettingsManager::getValue(QLatin1String("Content/VisitedLinkColor")).toString()).toUtf8());
 	QWebElement media(mainFrame()->findFirstElement(QLatin1String("img, audio source, video source")));
 	const bool isViewingMedia(!media.isNull() && QUrl(media.attribute(QLatin1String("src"))) == currentUrl);
+	const bool isViewingImage(isViewingMedia && media.tagName().toLower() == QLatin1String("img"));
 
-	if (isViewingMedia && media.tagName().toLower() == QLatin1String("img"))
+	if (isViewingImage)
 	{
-		styleSheet += QLatin1String("html {width:100%;height:100%;} body {display:-webkit-flex;margin:0;padding:0;-webkit-align-items:center;text-align:center;} img {max-width:100%;max-height:100%;margin:auto;-webkit-user-select:none;} .zoomedIn {display:table;} .zoomedIn body {display:table-cell;vertical-align:middle;} .zoomedIn img {max-width:none;max-height:none;cursor:-webkit-zoom-out;} .zoomedIn .drag {cursor:move;} .zoomedOut img {cursor:-webkit-zoom-in;}");
-
 		settings()->setAttribute(QWebSettings::AutoLoadImages, true);
 		settings()->setAttribute(QWebSettings::JavascriptEnabled, true);
 
@@ -194,22 +172,61 @@ void QtWebKitPage::updateStyleSheets(const QUrl &url)
 		emit viewingMediaChanged(m_isViewingMedia);
 	}
 
-	if (!SettingsManager::getValue(QLatin1String("Interface/ShowScrollBars")).toBool())
+	const QString textColor(SettingsManager::getValue(QLatin1String("Content/TextColor")).toString());
+	const QString linkColor(SettingsManager::getValue(QLatin1String("Content/LinkColor")).toString());
+	const QString visitedLinkColor(SettingsManager::getValue(QLatin1String("Content/VisitedLinkColor")).toString());
+	const QString userSyleSheet(m_widget ? m_widget->getOption(QLatin1String("Content/UserStyleSheet"), currentUrl).toString() : QString());
+	const QStringList profiles(m_widget ? m_widget->getOption(QLatin1String("Content/BlockingProfiles"), currentUrl).toStringList() : QStringList());
+	const bool showScrollBars(SettingsManager::getValue(QLatin1String("Interface/ShowScrollBars")).toBool());
+	const QString key(QStringList({currentUrl.host(), profiles.join(QLatin1Char(',')), userSyleSheet, textColor, linkColor, visitedLinkColor, QString::number(showScrollBars), QString::number(isViewingImage)}).join(QLatin1Char('\n')));
+
+	QUrl *cachedStyleSheetUrl(m_styleSheets.object(key));
+	QUrl styleSheetUrl;
+
+	if (cachedStyleSheetUrl)
 	{
-		styleSheet.append(QLatin1String("body::-webkit-scrollbar {display:none;}"));
+		styleSheetUrl = *cachedStyleSheetUrl;
 	}
+	else
+	{
+		QString styleSheet(QStringLiteral("html {color: %1;} a {color: %2;} a:visited {color: %3;}").arg(textColor).arg(linkColor).arg(visitedLinkColor));
 
-	const QString userSyleSheet(m_widget ? m_widget->getOption(QLatin1String("Content/UserStyleSheet"), currentUrl).toString() : QString());
+		if (isViewingImage)
+		{
+			styleSheet += QLatin1String("html {width:100%;height:100%;} body {display:-webkit-flex;margin:0;padding:0;-webkit-align-items:center;text-align:center;} img {max-width:100%;max-height:100%;margin:auto;-webkit-user-select:none;} .zoomedIn {display:table;} .zoomedIn body {display:table-cell;vertical-align:middle;} .zoomedIn img {max-width:none;max-height:none;cursor:-webkit-zoom-out;} .zoomedIn .drag {cursor:move;} .zoomedOut img {cursor:-webkit-zoom-in;}");
+		}
 
-	if (!userSyleSheet.isEmpty())
-	{
-		QFile file(userSyleSheet);
-		file.open(QIODevice::ReadOnly);
+		if (!showScrollBars)
+		{
+			styleSheet.append(QLatin1String("body::-webkit-scrollbar {display:none;}"));
+		}
 
-		styleSheet.append(file.readAll());
+		if (m_widget)
+		{
+			styleSheet.append(ContentBlockingManager::getElementHidingStyleSheet(currentUrl.host(), ContentBlockingManager::getProfileList(profiles)));
+		}
+
+		if (!userSyleSheet.isEmpty())
+		{
+			styleSheet.append(QtWebKitWebBackend::getUserStyleSheet(userSyleSheet));
+		}
+
+		const QByteArray encodedStyleSheet(styleSheet.toUtf8().toBase64());
+
+		styleSheetUrl = QUrl(QLatin1String("data:text/css;charset=utf-8;base64,") + encodedStyleSheet);
+
+		m_styleSheets.insert(key, new QUrl(styleSheetUrl), encodedStyleSheet.size());
+	}
+
+	if (settings()->userStyleSheetUrl() != styleSheetUrl)
+	{
+		settings()->setUserStyleSheetUrl(styleSheetUrl);
 	}
+}
 
-	settings()->setUserStyleSheetUrl(QUrl(QLatin1String("data:text/css;charset=utf-8;base64,") + styleSheet.toUtf8().toBase64()));
+void QtWebKitPage::clearStyleSheets()
+{
+	m_styleSheets.clear();
 }
 
 void QtWebKitPage::javaScriptAlert(QWebFrame *frame, const QString &message)
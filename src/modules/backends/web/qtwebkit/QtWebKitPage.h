@@ -23,6 +23,7 @@
 
 #include "../../../../core/WindowsManager.h"
 
+#include <QtCore/QCache>
 #include <QtWebKit/QWebElement>
 #include <QtWebKitWidgets/QWebPage>
 
@@ -56,7 +57,7 @@ protected:
 	QtWebKitPage();
 
 	void markAsPopup();
-	void applyContentBlockingRules(const QStringList &rules, bool remove);
+	static void clearStyleSheets();
 	void javaScriptAlert(QWebFrame *frame, const QString &message);
 	void javaScriptConsoleMessage(const QString &note, int line, const QString &source);
 	QWebPage* createWindow(WebWindowType type);
@@ -79,6 +80,8 @@ private:
 	bool m_isPopup;
 	bool m_isViewingMedia;
 
+	static QCache<QString, QUrl> m_styleSheets;
+
 signals:
 	void requestedNewWindow(WebWidget *widget, WindowsManager::OpenHints hints);
 	void requestedPopupWindow(const QUrl &parentUrl, const QUrl &popupUrl);
@@ -22,12 +22,17 @@
 #include "QtWebKitHistoryInterface.h"
 #include "QtWebKitPage.h"
 #include "QtWebKitWebWidget.h"
+#include "../../../../core/ContentBlockingManager.h"
 #include "../../../../core/NetworkManagerFactory.h"
 #include "../../../../core/SettingsManager.h"
+#include "../../../../core/UserScript.h"
 #include "../../../../core/Utils.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QRegularExpression>
 #include <QtWebKit/QWebHistoryInterface>
 #include <QtWebKit/QWebSettings>
@@ -39,8 +44,12 @@ QtWebKitWebBackend* QtWebKitWebBackend::m_instance = NULL;
 QPointer<WebWidget> QtWebKitWebBackend::m_activeWidget = NULL;
 QMap<QString, QString> QtWebKitWebBackend::m_userAgentComponents;
 QMap<QString, QString> QtWebKitWebBackend::m_userAgents;
+QHash<QString, QString> QtWebKitWebBackend::m_userStyleSheets;
+QHash<QObject*, QString> QtWebKitWebBackend::m_userScripts;
+QStringList QtWebKitWebBackend::m_formExtractorScript;
 
 QtWebKitWebBackend::QtWebKitWebBackend(QObject *parent) : WebBackend(parent),
+	m_styleSheetWatcher(new QFileSystemWatcher(this)),
 	m_isInitialized(false)
 {
 	m_instance = this;
@@ -53,6 +62,8 @@ QtWebKitWebBackend::QtWebKitWebBackend(QObject *parent) : WebBackend(parent),
 	m_userAgentComponents[QLatin1String("applicationVersion")] = QCoreApplication::applicationName() + QLatin1Char('/') + QCoreApplication::applicationVersion();
 
 	page->deleteLater();
+
+	connect(m_styleSheetWatcher, SIGNAL(fileChanged(QString)), this, SLOT(updateUserStyleSheet(QString)));
 }
 
 QtWebKitWebBackend::~QtWebKitWebBackend()
@@ -102,6 +113,30 @@ void QtWebKitWebBackend::optionChanged(const QString &option)
 	globalSettings->setOfflineWebApplicationCacheQuota(SettingsManager::getValue(QLatin1String("Content/OfflineWebApplicationCacheLimit")).toInt() * 1024);
 }
 
+void QtWebKitWebBackend::clearStyleSheets()
+{
+	QtWebKitPage::clearStyleSheets();
+
+	emit styleSheetsChanged();
+}
+
+void QtWebKitWebBackend::updateUserStyleSheet(const QString &path)
+{
+	m_userStyleSheets.remove(path);
+
+	if (QFile::exists(path) && !m_styleSheetWatcher->files().contains(path))
+	{
+		m_styleSheetWatcher->addPath(path);
+	}
+
+	clearStyleSheets();
+}
+
+void QtWebKitWebBackend::removeUserScript(QObject *object)
+{
+	m_userScripts.remove(object);
+}
+
 void QtWebKitWebBackend::pageLoaded(bool success)
 {
 	QtWebKitPage *page(qobject_cast<QtWebKitPage*>(sender()));
@@ -188,6 +223,7 @@ WebWidget* QtWebKitWebBackend::createWidget(bool isPrivate, ContentsWidget *pare
 		optionChanged(QLatin1String("Browser/"));
 
 		connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString)));
+		connect(ContentBlockingManager::getInstance(), SIGNAL(profileModified(QString)), this, SLOT(clearStyleSheets()));
 	}
 
 	QtWebKitWebWidget *widget(new QtWebKitWebWidget(isPrivate, this, NULL, parent));
@@ -276,6 +312,62 @@ QString QtWebKitWebBackend::getActiveDictionary()
 	return QString();
 }
 
+QString QtWebKitWebBackend::getUserStyleSheet(const QString &path)
+{
+	if (!m_userStyleSheets.contains(path))
+	{
+		QFile file(path);
+		file.open(QIODevice::ReadOnly);
+
+		m_userStyleSheets[path] = QString::fromUtf8(file.readAll());
+
+		file.close();
+
+		if (m_instance && QFile::exists(path) && !m_instance->m_styleSheetWatcher->files().contains(path))
+		{
+			m_instance->m_styleSheetWatcher->addPath(path);
+		}
+	}
+
+	return m_userStyleSheets[path];
+}
+
+QString QtWebKitWebBackend::getUserScriptSource(UserScript *script)
+{
+	if (!m_userScripts.contains(script))
+	{
+		QJsonArray array;
+		array.append(script->getSource());
+
+		QString source(QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Compact)));
+		source = source.mid(1, (source.length() - 2)).replace(QChar(0x2028), QLatin1String("\\u2028")).replace(QChar(0x2029), QLatin1String("\\u2029"));
+
+		m_userScripts[script] = QLatin1String("try { var start = now(); (0, eval)(") + source + QLatin1String("); results.push(now() - start); } catch (error) { results.push(String(error)); }\n");
+
+		if (m_instance)
+		{
+			connect(script, SIGNAL(destroyed(QObject*)), m_instance, SLOT(removeUserScript(QObject*)), Qt::UniqueConnection);
+		}
+	}
+
+	return m_userScripts[script];
+}
+
+QString QtWebKitWebBackend::getFormExtractorScript(const QString &token)
+{
+	if (m_formExtractorScript.isEmpty())
+	{
+		QFile file(QLatin1String(":/modules/backends/web/qtwebkit/resources/formExtractor.js"));
+		file.open(QIODevice::ReadOnly);
+
+		m_formExtractorScript = QString(file.readAll()).split(QLatin1String("%1"));
+
+		file.close();
+	}
+
+	return m_formExtractorScript.join(token);
+}
+
 QList<SpellCheckManager::DictionaryInformation> QtWebKitWebBackend::getDictionaries() const
 {
 	return SpellCheckManager::getDictionaries();
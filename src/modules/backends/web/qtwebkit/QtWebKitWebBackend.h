@@ -22,11 +22,15 @@
 
 #include "../../../../core/WebBackend.h"
 
+#include <QtCore/QFileSystemWatcher>
+
 namespace Otter
 {
 
 class QtWebKitPage;
 class QtWebKitSpellChecker;
+class QtWebKitWebWidget;
+class UserScript;
 
 class QtWebKitWebBackend : public WebBackend
 {
@@ -51,13 +55,20 @@ public:
 protected:
 	static QtWebKitWebBackend* getInstance();
 	static QString getActiveDictionary();
+	static QString getUserStyleSheet(const QString &path);
+	static QString getUserScriptSource(UserScript *script);
+	static QString getFormExtractorScript(const QString &token);
 
 protected slots:
 	void optionChanged(const QString &option);
+	void clearStyleSheets();
+	void updateUserStyleSheet(const QString &path);
+	void removeUserScript(QObject *object);
 	void pageLoaded(bool success);
 	void setActiveWidget(WebWidget *widget);
 
 private:
+	QFileSystemWatcher *m_styleSheetWatcher;
 	QHash<QtWebKitPage*, QPair<QUrl, QSize> > m_thumbnailRequests;
 	bool m_isInitialized;
 
@@ -65,11 +76,17 @@ private:
 	static QPointer<WebWidget> m_activeWidget;
 	static QMap<QString, QString> m_userAgentComponents;
 	static QMap<QString, QString> m_userAgents;
+	static QHash<QString, QString> m_userStyleSheets;
+	static QHash<QObject*, QString> m_userScripts;
+	static QStringList m_formExtractorScript;
 
 signals:
 	void activeDictionaryChanged(const QString &dictionary);
+	void styleSheetsChanged();
 
+friend class QtWebKitPage;
 friend class QtWebKitSpellChecker;
+friend class QtWebKitWebWidget;
 };
 
 }
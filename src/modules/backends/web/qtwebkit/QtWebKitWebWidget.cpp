@@ -24,6 +24,7 @@
 #include "QtWebKitPluginFactory.h"
 #include "QtWebKitPluginWidget.h"
 #include "QtWebKitPage.h"
+#include "QtWebKitWebBackend.h"
 #include "../../../../core/ActionsManager.h"
 #include "../../../../core/AddonsManager.h"
 #include "../../../../core/BookmarksManager.h"
@@ -52,6 +53,7 @@
 #include "../../../../ui/WebsitePreferencesDialog.h"
 
 #include <QtCore/QDataStream>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFileInfo>
 #include <QtCore/QMimeData>
 #include <QtCore/QTimer>
@@ -68,6 +70,8 @@
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QVBoxLayout>
 
+#define QTWEBKITWEBWIDGET_SLOW_USER_SCRIPT_TIME 50
+
 namespace Otter
 {
 
@@ -305,72 +309,61 @@ void QtWebKitWebWidget::pageLoadFinished()
 	emit contentStateChanged(getContentState());
 	emit loadingStateChanged(WindowsManager::FinishedLoadingState);
 
-	QList<QWebFrame*> frames;
 	const QList<UserScript*> scripts(AddonsManager::getUserScriptsForUrl(getUrl()));
+	const bool isExtractingForms(SettingsManager::getValue(QLatin1String("Browser/EnablePasswordsManager")).toBool() && SettingsManager::getValue(QLatin1String("Browser/AskToSavePassword")).toBool());
 
-	for (int i = 0; i < scripts.count(); ++i)
+	if (scripts.isEmpty() && !isExtractingForms)
 	{
-		if (scripts.at(i)->shouldRunOnSubFrames())
-		{
-			if (frames.isEmpty())
-			{
-				QList<QWebFrame*> temporaryFrames;
-				temporaryFrames.append(m_page->mainFrame());
-
-				while (!temporaryFrames.isEmpty())
-				{
-					QWebFrame *frame(temporaryFrames.takeFirst());
-
-					frames.append(frame);
+		return;
+	}
 
-					temporaryFrames.append(frame->childFrames());
-				}
-			}
+	QList<UserScript*> subFramesScripts;
 
-			for (int j = 0; j < frames.count(); ++j)
-			{
-				frames.at(j)->documentElement().evaluateJavaScript(scripts.at(i)->getSource());
-			}
-		}
-		else
+	for (int i = 0; i < scripts.count(); ++i)
+	{
+		if (scripts.at(i)->shouldRunOnSubFrames())
 		{
-			m_page->mainFrame()->documentElement().evaluateJavaScript(scripts.at(i)->getSource());
+			subFramesScripts.append(scripts.at(i));
 		}
 	}
 
-	if (!SettingsManager::getValue(QLatin1String("Browser/EnablePasswordsManager")).toBool() || !SettingsManager::getValue(QLatin1String("Browser/AskToSavePassword")).toBool())
+	QString formExtractorScript;
+
+	if (isExtractingForms)
 	{
-		return;
+		m_passwordToken = QUuid::createUuid().toString();
+
+		formExtractorScript = QtWebKitWebBackend::getFormExtractorScript(m_passwordToken);
 	}
 
-	m_passwordToken = QUuid::createUuid().toString();
+	QHash<UserScript*, qreal> times;
 
-	QFile file(QLatin1String(":/modules/backends/web/qtwebkit/resources/formExtractor.js"));
-	file.open(QIODevice::ReadOnly);
+	evaluateUserScripts(m_page->mainFrame(), createUserScriptsBatch(scripts, formExtractorScript), scripts, &times);
 
-	if (frames.isEmpty())
+	if (!subFramesScripts.isEmpty() || isExtractingForms)
 	{
-		QList<QWebFrame*> temporaryFrames;
-		temporaryFrames.append(m_page->mainFrame());
+		const QString batch(createUserScriptsBatch(subFramesScripts, formExtractorScript));
+		QList<QWebFrame*> frames(m_page->mainFrame()->childFrames());
 
-		while (!temporaryFrames.isEmpty())
+		while (!frames.isEmpty())
 		{
-			QWebFrame *frame(temporaryFrames.takeFirst());
+			QWebFrame *frame(frames.takeFirst());
 
-			frames.append(frame);
+			evaluateUserScripts(frame, batch, subFramesScripts, &times);
 
-			temporaryFrames.append(frame->childFrames());
+			frames.append(frame->childFrames());
 		}
 	}
 
-	const QString script(QString(file.readAll()).arg(m_passwordToken));
-
-	for (int j = 0; j < frames.count(); ++j)
+	for (int i = 0; i < scripts.count(); ++i)
 	{
-		frames.at(j)->documentElement().evaluateJavaScript(script);
-	}
+		const qreal time(times.value(scripts.at(i), 0));
 
-	file.close();
+		if (time >= QTWEBKITWEBWIDGET_SLOW_USER_SCRIPT_TIME)
+		{
+			Console::addMessage(tr("User script %1 took %2 ms to run").arg(scripts.at(i)->getName()).arg(qRound(time)), JavaScriptMessageCategory, WarningMessageLevel, getUrl().toString(), -1, getWindowIdentifier());
+		}
+	}
 }
 
 void QtWebKitWebWidget::downloadFile(const QNetworkRequest &request)
@@ -2413,6 +2406,68 @@ bool QtWebKitWebWidget::isNavigating() const
 	return m_isNavigating;
 }
 
+QString QtWebKitWebWidget::createUserScriptsBatch(const QList<UserScript*> &scripts, const QString &extraScript)
+{
+	if (scripts.isEmpty() && extraScript.isEmpty())
+	{
+		return QString();
+	}
+
+	QString batch(QLatin1String("(function() { var now = ((window.performance && window.performance.now) ? function() { return window.performance.now(); } : Date.now); var results = []; var canEvaluate = true;\ntry { (0, eval)('1'); } catch (error) { canEvaluate = false; }\nif (canEvaluate) {\n"));
+
+	for (int i = 0; i < scripts.count(); ++i)
+	{
+		batch.append(QtWebKitWebBackend::getUserScriptSource(scripts.at(i)));
+	}
+
+	batch.append(QLatin1String("}\n"));
+	batch.append(extraScript);
+	batch.append(QLatin1String("\nreturn (canEvaluate ? results : false); })()"));
+
+	return batch;
+}
+
+void QtWebKitWebWidget::evaluateUserScripts(QWebFrame *frame, const QString &batch, const QList<UserScript*> &scripts, QHash<UserScript*, qreal> *times)
+{
+	if (batch.isEmpty())
+	{
+		return;
+	}
+
+	const QVariant batchResult(frame->documentElement().evaluateJavaScript(batch));
+
+	if (batchResult.type() == QVariant::Bool)
+	{
+		for (int i = 0; i < scripts.count(); ++i)
+		{
+			QElapsedTimer timer;
+			timer.start();
+
+			frame->documentElement().evaluateJavaScript(scripts.at(i)->getSource());
+
+			(*times)[scripts.at(i)] += timer.elapsed();
+		}
+
+		return;
+	}
+
+	const QVariantList results(batchResult.toList());
+
+	for (int i = 0; i < scripts.count(); ++i)
+	{
+		const QVariant result(results.value(i));
+
+		if (result.type() == QVariant::String)
+		{
+			Console::addMessage(tr("User script %1 failed: %2").arg(scripts.at(i)->getName()).arg(result.toString()), JavaScriptMessageCategory, ErrorMessageLevel, frame->url().toString(), -1, getWindowIdentifier());
+		}
+		else
+		{
+			(*times)[scripts.at(i)] += result.toReal();
+		}
+	}
+}
+
 bool QtWebKitWebWidget::isScrollBar(const QPoint &position) const
 {
 	return (m_page->mainFrame()->scrollBarGeometry(Qt::Horizontal).contains(position) || m_page->mainFrame()->scrollBarGeometry(Qt::Vertical).contains(position));
@@ -42,6 +42,7 @@ class QtWebKitWebBackend;
 class QtWebKitPage;
 class QtWebKitPluginFactory;
 class SourceViewerWebWidget;
+class UserScript;
 
 class QtWebKitWebWidget : public WebWidget
 {
@@ -132,6 +133,10 @@ protected:
 	bool isNavigating() const;
 	bool isScrollBar(const QPoint &position) const;
 
+	void evaluateUserScripts(QWebFrame *frame, const QString &batch, const QList<UserScript*> &scripts, QHash<UserScript*, qreal> *times);
+
+	static QString createUserScriptsBatch(const QList<UserScript*> &scripts, const QString &extraScript);
+
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
 	void navigating(const QUrl &url, QWebFrame *frame, QWebPage::NavigationType type);
@@ -0,0 +1,325 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2016 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "ContentBlockingContentsWidget.h"
+#include "../../../core/ActionsManager.h"
+#include "../../../core/ContentBlockingManager.h"
+#include "../../../core/ContentBlockingProfile.h"
+#include "../../../core/ThemesManager.h"
+
+#include "ui_ContentBlockingContentsWidget.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QStandardPaths>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
+
+#define CONTENTBLOCKINGCONTENTSWIDGET_RULES_LIMIT 500
+#define CONTENTBLOCKINGCONTENTSWIDGET_UPDATE_INTERVAL 1000
+
+namespace Otter
+{
+
+ContentBlockingContentsWidget::ContentBlockingContentsWidget(Window *window) : ContentsWidget(window),
+	m_profilesModel(new QStandardItemModel(this)),
+	m_rulesModel(new QStandardItemModel(this)),
+	m_requestsAmount(-1),
+	m_updateTimer(0),
+	m_ui(new Ui::ContentBlockingContentsWidget)
+{
+	m_ui->setupUi(this);
+	m_ui->profilesViewWidget->setModel(m_profilesModel);
+	m_ui->rulesViewWidget->setModel(m_rulesModel);
+
+	updateStatistics();
+
+	m_updateTimer = startTimer(CONTENTBLOCKINGCONTENTSWIDGET_UPDATE_INTERVAL);
+
+	connect(m_ui->filterLineEdit, SIGNAL(textChanged(QString)), m_ui->rulesViewWidget, SLOT(setFilterString(QString)));
+	connect(m_ui->exportButton, SIGNAL(clicked()), this, SLOT(exportStatistics()));
+	connect(m_ui->resetButton, SIGNAL(clicked()), this, SLOT(resetStatistics()));
+}
+
+ContentBlockingContentsWidget::~ContentBlockingContentsWidget()
+{
+	delete m_ui;
+}
+
+void ContentBlockingContentsWidget::changeEvent(QEvent *event)
+{
+	QWidget::changeEvent(event);
+
+	if (event->type() == QEvent::LanguageChange)
+	{
+		m_ui->retranslateUi(this);
+
+		m_requestsAmount = -1;
+
+		updateStatistics();
+	}
+}
+
+void ContentBlockingContentsWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_updateTimer && isVisible())
+	{
+		updateStatistics();
+	}
+}
+
+void ContentBlockingContentsWidget::print(QPrinter *printer)
+{
+	m_ui->rulesViewWidget->render(printer);
+}
+
+void ContentBlockingContentsWidget::triggerAction(int identifier, const QVariantMap &parameters)
+{
+	Q_UNUSED(parameters)
+
+	switch (identifier)
+	{
+		case ActionsManager::ReloadAction:
+			m_requestsAmount = -1;
+
+			updateStatistics();
+
+			break;
+		case ActionsManager::FindAction:
+		case ActionsManager::QuickFindAction:
+		case ActionsManager::ActivateAddressFieldAction:
+			m_ui->filterLineEdit->setFocus();
+
+			break;
+		case ActionsManager::ActivateContentAction:
+			m_ui->rulesViewWidget->setFocus();
+
+			break;
+		default:
+			break;
+	}
+}
+
+void ContentBlockingContentsWidget::exportStatistics()
+{
+	const QString path(QFileDialog::getSaveFileName(this, tr("Select File"), QStandardPaths::standardLocations(QStandardPaths::HomeLocation).value(0), tr("JSON files (*.json)")));
+
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		QMessageBox::critical(this, tr("Error"), tr("Failed to open file for writing."), QMessageBox::Close);
+
+		return;
+	}
+
+	file.write(ContentBlockingManager::exportStatistics());
+	file.close();
+}
+
+void ContentBlockingContentsWidget::resetStatistics()
+{
+	ContentBlockingManager::resetStatistics();
+
+	m_requestsAmount = -1;
+
+	updateStatistics();
+}
+
+void ContentBlockingContentsWidget::updateStatistics()
+{
+	const QVector<ContentBlockingInformation> profiles(ContentBlockingManager::getProfiles());
+	const QVector<ContentBlockingManager::ProfileStatistics> statistics(ContentBlockingManager::getStatistics());
+	int requestsAmount(0);
+
+	for (int i = 0; i < statistics.count(); ++i)
+	{
+		requestsAmount += statistics.at(i).requests;
+	}
+
+	if (requestsAmount == m_requestsAmount)
+	{
+		return;
+	}
+
+	if (m_requestsAmount < 0 || requestsAmount < m_requestsAmount)
+	{
+		const QVector<int> latencyBuckets(ContentBlockingManager::getLatencyBuckets());
+		QStringList profilesLabels({tr("Title"), tr("Requests"), tr("Blocked"), tr("Total Time"), tr("Average Time"), tr("Rules per Request")});
+
+		for (int i = 0; i < latencyBuckets.count(); ++i)
+		{
+			profilesLabels.append(tr("< %1 µs").arg(latencyBuckets.at(i)));
+		}
+
+		profilesLabels.append(tr("≥ %1 µs").arg(latencyBuckets.value((latencyBuckets.count() - 1), 0)));
+
+		m_profilesModel->setHorizontalHeaderLabels(profilesLabels);
+		m_rulesModel->removeRows(0, m_rulesModel->rowCount());
+		m_rulesModel->setHorizontalHeaderLabels(QStringList({tr("Rule"), tr("Profile"), tr("Hits")}));
+
+		m_ruleItems.clear();
+	}
+
+	m_requestsAmount = requestsAmount;
+
+	const int profilesAmount(qMin(profiles.count(), statistics.count()));
+
+	if (m_profilesModel->rowCount() > profilesAmount)
+	{
+		m_profilesModel->removeRows(profilesAmount, (m_profilesModel->rowCount() - profilesAmount));
+	}
+
+	QVector<QPair<int, QPair<QString, int> > > rules;
+
+	for (int i = 0; i < profilesAmount; ++i)
+	{
+		const ContentBlockingManager::ProfileStatistics &profileStatistics(statistics.at(i));
+		const int requests(qMax(1, profileStatistics.requests));
+
+		if (i >= m_profilesModel->rowCount())
+		{
+			QList<QStandardItem*> items;
+
+			for (int j = 0; j < m_profilesModel->columnCount(); ++j)
+			{
+				items.append(new QStandardItem());
+			}
+
+			m_profilesModel->appendRow(items);
+		}
+
+		m_profilesModel->item(i, 0)->setText(profiles.at(i).title.isEmpty() ? profiles.at(i).name : profiles.at(i).title);
+		m_profilesModel->item(i, 1)->setData(profileStatistics.requests, Qt::DisplayRole);
+		m_profilesModel->item(i, 2)->setData(profileStatistics.blockedRequests, Qt::DisplayRole);
+		m_profilesModel->item(i, 3)->setText(tr("%1 ms").arg((profileStatistics.totalTime / 1000000.0), 0, 'f', 2));
+		m_profilesModel->item(i, 4)->setText(tr("%1 µs").arg((profileStatistics.totalTime / (requests * 1000.0)), 0, 'f', 2));
+		m_profilesModel->item(i, 5)->setText(QString::number((static_cast<double>(profileStatistics.evaluatedRules) / requests), 'f', 2));
+
+		for (int j = 0; j < profileStatistics.latencyHistogram.count() && (j + 6) < m_profilesModel->columnCount(); ++j)
+		{
+			m_profilesModel->item(i, (j + 6))->setData(profileStatistics.latencyHistogram.at(j), Qt::DisplayRole);
+		}
+
+		QHash<QString, int>::const_iterator iterator;
+
+		for (iterator = profileStatistics.ruleHits.constBegin(); iterator != profileStatistics.ruleHits.constEnd(); ++iterator)
+		{
+			QStandardItem *hitsItem(m_ruleItems.value(profiles.at(i).name + QLatin1Char('\n') + iterator.key()));
+
+			if (hitsItem)
+			{
+				hitsItem->setData(iterator.value(), Qt::DisplayRole);
+			}
+			else
+			{
+				rules.append(qMakePair(iterator.value(), qMakePair(iterator.key(), i)));
+			}
+		}
+	}
+
+	if (rules.isEmpty())
+	{
+		return;
+	}
+
+	qSort(rules.begin(), rules.end(), [&](const QPair<int, QPair<QString, int> > &first, const QPair<int, QPair<QString, int> > &second)
+	{
+		return (first.first > second.first);
+	});
+
+	int rule(0);
+
+	while (rule < rules.count() && m_rulesModel->rowCount() < CONTENTBLOCKINGCONTENTSWIDGET_RULES_LIMIT)
+	{
+		const ContentBlockingInformation &profile(profiles.at(rules.at(rule).second.second));
+		const QString key(profile.name + QLatin1Char('\n') + rules.at(rule).second.first);
+		QList<QStandardItem*> items({new QStandardItem(rules.at(rule).second.first), new QStandardItem(profile.title.isEmpty() ? profile.name : profile.title), new QStandardItem()});
+		items[0]->setData(key, Qt::UserRole);
+		items[2]->setData(rules.at(rule).first, Qt::DisplayRole);
+
+		m_rulesModel->appendRow(items);
+
+		m_ruleItems[key] = items[2];
+
+		++rule;
+	}
+
+	if (rule >= rules.count())
+	{
+		return;
+	}
+
+	QList<QStandardItem*> hitsItems(m_ruleItems.values());
+
+	qSort(hitsItems.begin(), hitsItems.end(), [&](QStandardItem *first, QStandardItem *second)
+	{
+		return (first->data(Qt::DisplayRole).toInt() < second->data(Qt::DisplayRole).toInt());
+	});
+
+	for (int i = 0; i < hitsItems.count() && rule < rules.count(); ++i, ++rule)
+	{
+		if (rules.at(rule).first <= hitsItems.at(i)->data(Qt::DisplayRole).toInt())
+		{
+			break;
+		}
+
+		const ContentBlockingInformation &profile(profiles.at(rules.at(rule).second.second));
+		const QString key(profile.name + QLatin1Char('\n') + rules.at(rule).second.first);
+		const int row(hitsItems.at(i)->row());
+		QStandardItem *ruleItem(m_rulesModel->item(row, 0));
+
+		m_ruleItems.remove(ruleItem->data(Qt::UserRole).toString());
+
+		ruleItem->setText(rules.at(rule).second.first);
+		ruleItem->setData(key, Qt::UserRole);
+
+		m_rulesModel->item(row, 1)->setText(profile.title.isEmpty() ? profile.name : profile.title);
+
+		hitsItems.at(i)->setData(rules.at(rule).first, Qt::DisplayRole);
+
+		m_ruleItems[key] = hitsItems.at(i);
+	}
+}
+
+QString ContentBlockingContentsWidget::getTitle() const
+{
+	return tr("Content Blocking Statistics");
+}
+
+QLatin1String ContentBlockingContentsWidget::getType() const
+{
+	return QLatin1String("blocking");
+}
+
+QUrl ContentBlockingContentsWidget::getUrl() const
+{
+	return QUrl(QLatin1String("about:blocking"));
+}
+
+QIcon ContentBlockingContentsWidget::getIcon() const
+{
+	return ThemesManager::getIcon(QLatin1String("content-blocking"), false);
+}
+
+}
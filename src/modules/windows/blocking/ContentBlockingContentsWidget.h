@@ -0,0 +1,74 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2016 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_CONTENTBLOCKINGCONTENTSWIDGET_H
+#define OTTER_CONTENTBLOCKINGCONTENTSWIDGET_H
+
+#include "../../../ui/ContentsWidget.h"
+
+#include <QtGui/QStandardItemModel>
+
+namespace Otter
+{
+
+namespace Ui
+{
+	class ContentBlockingContentsWidget;
+}
+
+class Window;
+
+class ContentBlockingContentsWidget : public ContentsWidget
+{
+	Q_OBJECT
+
+public:
+	explicit ContentBlockingContentsWidget(Window *window);
+	~ContentBlockingContentsWidget();
+
+	void print(QPrinter *printer);
+	QString getTitle() const;
+	QLatin1String getType() const;
+	QUrl getUrl() const;
+	QIcon getIcon() const;
+
+public slots:
+	void triggerAction(int identifier, const QVariantMap &parameters = QVariantMap());
+
+protected:
+	void changeEvent(QEvent *event);
+	void timerEvent(QTimerEvent *event);
+
+protected slots:
+	void exportStatistics();
+	void resetStatistics();
+	void updateStatistics();
+
+private:
+	QStandardItemModel *m_profilesModel;
+	QHash<QString, QStandardItem*> m_ruleItems;
+	QStandardItemModel *m_rulesModel;
+	int m_requestsAmount;
+	int m_updateTimer;
+	Ui::ContentBlockingContentsWidget *m_ui;
+};
+
+}
+
+#endif
@@ -27,15 +27,19 @@
 #include "ui_CookiesContentsWidget.h"
 
 #include <QtCore/QTimer>
+#include <QtCore/QTimerEvent>
 #include <QtGui/QKeyEvent>
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QMessageBox>
 
+#define COOKIES_POPULATE_CHUNK 500
+
 namespace Otter
 {
 
 CookiesContentsWidget::CookiesContentsWidget(Window *window) : ContentsWidget(window),
 	m_model(new QStandardItemModel(this)),
+	m_populateTimer(0),
 	m_isLoading(true),
 	m_ui(new Ui::CookiesContentsWidget)
 {
@@ -60,6 +64,41 @@ CookiesContentsWidget::~CookiesContentsWidget()
 	delete m_ui;
 }
 
+void CookiesContentsWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_populateTimer)
+	{
+		return;
+	}
+
+	const int amount(qMin(COOKIES_POPULATE_CHUNK, m_pendingCookies.count()));
+
+	for (int i = 0; i < amount; ++i)
+	{
+		const QNetworkCookie cookie(m_pendingCookies.takeFirst());
+
+		if (m_pendingCookieKeys.remove(getCookieKey(cookie)))
+		{
+			addCookie(cookie);
+		}
+	}
+
+	if (!m_pendingCookies.isEmpty())
+	{
+		return;
+	}
+
+	killTimer(m_populateTimer);
+
+	m_populateTimer = 0;
+
+	m_pendingCookieKeys.clear();
+
+	m_isLoading = false;
+
+	emit loadingStateChanged(WindowsManager::FinishedLoadingState);
+}
+
 void CookiesContentsWidget::changeEvent(QEvent *event)
 {
 	QWidget::changeEvent(event);
@@ -73,54 +112,70 @@ void CookiesContentsWidget::changeEvent(QEvent *event)
 void CookiesContentsWidget::populateCookies()
 {
 	CookieJar *cookieJar(qobject_cast<CookieJar*>(NetworkManagerFactory::getCookieJar()));
-	const QList<QNetworkCookie> cookies(cookieJar->getCookies());
 
-	for (int i = 0; i < cookies.count(); ++i)
+	m_pendingCookies = cookieJar->getCookies();
+
+	qSort(m_pendingCookies.begin(), m_pendingCookies.end(), [&](const QNetworkCookie &first, const QNetworkCookie &second)
 	{
-		addCookie(cookies.at(i));
-	}
+		const QString firstDomain(first.domain().startsWith(QLatin1Char('.')) ? first.domain().mid(1) : first.domain());
+		const QString secondDomain(second.domain().startsWith(QLatin1Char('.')) ? second.domain().mid(1) : second.domain());
+
+		return ((firstDomain == secondDomain) ? (first.name() < second.name()) : (firstDomain < secondDomain));
+	});
 
-	m_model->sort(0);
+	for (int i = 0; i < m_pendingCookies.count(); ++i)
+	{
+		m_pendingCookieKeys.insert(getCookieKey(m_pendingCookies.at(i)));
+	}
 
 	m_ui->cookiesViewWidget->setViewMode(ItemViewWidget::TreeViewMode);
 	m_ui->cookiesViewWidget->setModel(m_model);
 
-	m_isLoading = false;
-
-	emit loadingStateChanged(WindowsManager::FinishedLoadingState);
-
-	connect(cookieJar, SIGNAL(cookieAdded(QNetworkCookie)), this, SLOT(addCookie(QNetworkCookie)));
-	connect(cookieJar, SIGNAL(cookieRemoved(QNetworkCookie)), this, SLOT(removeCookie(QNetworkCookie)));
 	connect(m_model, SIGNAL(modelReset()), this, SLOT(updateActions()));
 	connect(m_ui->cookiesViewWidget, SIGNAL(needsActionsUpdate()), this, SLOT(updateActions()));
+	connect(cookieJar, SIGNAL(cookieAdded(QNetworkCookie)), this, SLOT(addCookie(QNetworkCookie)));
+	connect(cookieJar, SIGNAL(cookieRemoved(QNetworkCookie)), this, SLOT(removeCookie(QNetworkCookie)));
+
+	m_populateTimer = startTimer(0);
 }
 
 void CookiesContentsWidget::addCookie(const QNetworkCookie &cookie)
 {
-	const QString domain(cookie.domain().startsWith(QLatin1Char('.')) ? cookie.domain().mid(1) : cookie.domain());
-	QStandardItem *domainItem(findDomain(domain));
+	const QString key(getCookieKey(cookie));
 
-	if (domainItem)
+	if (m_cookieItems.contains(key))
 	{
-		for (int i = 0; i < domainItem->rowCount(); ++i)
-		{
-			if (domainItem->child(i, 0)->text() == cookie.name() && domainItem->child(i, 0)->data(Qt::UserRole).toString() == cookie.path())
-			{
-				return;
-			}
-		}
+		return;
 	}
-	else
+
+	const QString domain(cookie.domain().startsWith(QLatin1Char('.')) ? cookie.domain().mid(1) : cookie.domain());
+	QStandardItem *domainItem(findDomain(domain));
+
+	if (!domainItem)
 	{
 		domainItem = new QStandardItem(HistoryManager::getIcon(QUrl(QStringLiteral("http://%1/").arg(domain))), domain);
 		domainItem->setToolTip(domain);
 
-		m_model->appendRow(domainItem);
+		int first(0);
+		int last(m_model->rowCount());
 
-		if (sender())
+		while (first < last)
 		{
-			m_model->sort(0);
+			const int middle((first + last) / 2);
+
+			if (m_model->item(middle, 0)->toolTip() < domain)
+			{
+				first = (middle + 1);
+			}
+			else
+			{
+				last = middle;
+			}
 		}
+
+		m_model->insertRow(first, domainItem);
+
+		m_domainItems[domain] = domainItem;
 	}
 
 	QStandardItem *cookieItem(new QStandardItem(QString(cookie.name())));
@@ -131,45 +186,47 @@ void CookiesContentsWidget::addCookie(const QNetworkCookie &cookie)
 
 	domainItem->appendRow(cookieItem);
 	domainItem->setText(QStringLiteral("%1 (%2)").arg(domain).arg(domainItem->rowCount()));
+
+	m_cookieItems[key] = cookieItem;
 }
 
 void CookiesContentsWidget::removeCookie(const QNetworkCookie &cookie)
 {
-	const QString domain(cookie.domain().startsWith(QLatin1Char('.')) ? cookie.domain().mid(1) : cookie.domain());
-	QStandardItem *domainItem(findDomain(domain));
+	const QString key(getCookieKey(cookie));
 
-	if (domainItem)
+	if (m_isLoading)
 	{
-		QPoint point;
+		m_pendingCookieKeys.remove(key);
+	}
 
-		for (int j = 0; j < domainItem->rowCount(); ++j)
-		{
-			if (domainItem->child(j, 0)->text() == cookie.name() && domainItem->child(j, 0)->data(Qt::UserRole).toString() == cookie.path())
-			{
-				point = m_ui->cookiesViewWidget->visualRect(domainItem->child(j, 0)->index()).center();
+	QStandardItem *cookieItem(m_cookieItems.take(key));
+	QStandardItem *domainItem(cookieItem ? cookieItem->parent() : NULL);
 
-				domainItem->removeRow(j);
+	if (!domainItem)
+	{
+		return;
+	}
 
-				break;
-			}
-		}
+	const QPoint point(m_ui->cookiesViewWidget->visualRect(cookieItem->index()).center());
 
-		if (domainItem->rowCount() == 0)
-		{
-			m_model->invisibleRootItem()->removeRow(domainItem->row());
-		}
-		else
-		{
-			domainItem->setText(QStringLiteral("%1 (%2)").arg(domain).arg(domainItem->rowCount()));
-		}
+	domainItem->removeRow(cookieItem->row());
 
-		if (!point.isNull())
-		{
-			const QModelIndex index(m_ui->cookiesViewWidget->indexAt(point));
+	if (domainItem->rowCount() == 0)
+	{
+		m_domainItems.remove(domainItem->toolTip());
+		m_model->invisibleRootItem()->removeRow(domainItem->row());
+	}
+	else
+	{
+		domainItem->setText(QStringLiteral("%1 (%2)").arg(domainItem->toolTip()).arg(domainItem->rowCount()));
+	}
 
-			m_ui->cookiesViewWidget->setCurrentIndex(index);
-			m_ui->cookiesViewWidget->selectionModel()->select(index, QItemSelectionModel::Select);
-		}
+	if (!point.isNull())
+	{
+		const QModelIndex index(m_ui->cookiesViewWidget->indexAt(point));
+
+		m_ui->cookiesViewWidget->setCurrentIndex(index);
+		m_ui->cookiesViewWidget->selectionModel()->select(index, QItemSelectionModel::Select);
 	}
 }
 
@@ -411,15 +468,7 @@ void CookiesContentsWidget::filterCookies(const QString &filter)
 
 QStandardItem* CookiesContentsWidget::findDomain(const QString &domain)
 {
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		if (domain == m_model->item(i, 0)->toolTip())
-		{
-			return m_model->item(i, 0);
-		}
-	}
-
-	return NULL;
+	return m_domainItems.value(domain, NULL);
 }
 
 Action* CookiesContentsWidget::getAction(int identifier)
@@ -463,6 +512,13 @@ QIcon CookiesContentsWidget::getIcon() const
 	return ThemesManager::getIcon(QLatin1String("cookies"), false);
 }
 
+QString CookiesContentsWidget::getCookieKey(const QNetworkCookie &cookie) const
+{
+	const QString domain(cookie.domain().startsWith(QLatin1Char('.')) ? cookie.domain().mid(1) : cookie.domain());
+
+	return domain + QLatin1Char('\t') + cookie.path() + QLatin1Char('\t') + QString(cookie.name());
+}
+
 QNetworkCookie CookiesContentsWidget::getCookie(const QModelIndex &index) const
 {
 	QNetworkCookie cookie(index.data(Qt::DisplayRole).toString().toUtf8());
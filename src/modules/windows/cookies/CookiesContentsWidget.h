@@ -22,6 +22,7 @@
 
 #include "../../../ui/ContentsWidget.h"
 
+#include <QtCore/QSet>
 #include <QtGui/QStandardItemModel>
 #include <QtNetwork/QNetworkCookie>
 
@@ -56,8 +57,10 @@ public slots:
 	void triggerAction(int identifier, const QVariantMap &parameters = QVariantMap());
 
 protected:
+	void timerEvent(QTimerEvent *event);
 	void changeEvent(QEvent *event);
 	QStandardItem* findDomain(const QString &domain);
+	QString getCookieKey(const QNetworkCookie &cookie) const;
 	QNetworkCookie getCookie(const QModelIndex &index) const;
 
 protected slots:
@@ -73,7 +76,12 @@ protected slots:
 
 private:
 	QStandardItemModel *m_model;
+	QList<QNetworkCookie> m_pendingCookies;
+	QSet<QString> m_pendingCookieKeys;
+	QHash<QString, QStandardItem*> m_domainItems;
+	QHash<QString, QStandardItem*> m_cookieItems;
 	QHash<int, Action*> m_actions;
+	int m_populateTimer;
 	bool m_isLoading;
 	Ui::CookiesContentsWidget *m_ui;
 };
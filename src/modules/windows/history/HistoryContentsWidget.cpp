@@ -32,41 +32,475 @@
 namespace Otter
 {
 
-HistoryContentsWidget::HistoryContentsWidget(Window *window) : ContentsWidget(window),
-	m_model(new QStandardItemModel(this)),
-	m_isLoading(true),
-	m_ui(new Ui::HistoryContentsWidget)
+HistoryContentsModel::HistoryContentsModel(QObject *parent) : QAbstractItemModel(parent)
 {
-	m_ui->setupUi(this);
+	const QStringList titles({tr("Today"), tr("Yesterday"), tr("Earlier This Week"), tr("Previous Week"), tr("Earlier This Month"), tr("Earlier This Year"), tr("Older")});
+
+	m_groups.resize(titles.count());
+
+	for (int i = 0; i < titles.count(); ++i)
+	{
+		m_groups[i].title = titles.at(i);
+	}
+
+	connect(HistoryManager::getBrowsingHistoryModel(), SIGNAL(entryAdded(HistoryEntryItem*)), this, SLOT(addEntry(HistoryEntryItem*)));
+	connect(HistoryManager::getBrowsingHistoryModel(), SIGNAL(entryModified(HistoryEntryItem*)), this, SLOT(modifyEntry(HistoryEntryItem*)));
+	connect(HistoryManager::getBrowsingHistoryModel(), SIGNAL(entryRemoved(HistoryEntryItem*)), this, SLOT(removeEntry(HistoryEntryItem*)));
+}
+
+void HistoryContentsModel::reload()
+{
+	beginResetModel();
+
+	const QDate date(QDate::currentDate());
+	const QList<QDate> dates({date, date.addDays(-1), date.addDays(-7), date.addDays(-14), date.addDays(-30), date.addDays(-365)});
+
+	for (int i = 0; i < m_groups.count(); ++i)
+	{
+		m_groups[i].from = dates.value(i, QDate());
+		m_groups[i].to = ((i > 0) ? dates.value((i - 1), QDate()) : QDate());
+		m_groups[i].entries.clear();
+		m_groups[i].isPopulated = false;
+	}
+
+	m_entries.clear();
+
+	updateAmounts();
+	endResetModel();
+}
+
+void HistoryContentsModel::fetchMore(const QModelIndex &parent)
+{
+	if (!canFetchMore(parent))
+	{
+		return;
+	}
+
+	HistoryGroup &group(m_groups[parent.row()]);
+	const QList<HistoryEntryItem*> entries(HistoryManager::getBrowsingHistoryModel()->getEntries(group.from, group.to));
+	QMultiMap<QDateTime, quint64> sortedEntries;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		const quint64 identifier(entries.at(i)->data(HistoryModel::IdentifierRole).toULongLong());
+
+		if (identifier > 0)
+		{
+			sortedEntries.insert(entries.at(i)->data(HistoryModel::TimeVisitedRole).toDateTime(), identifier);
+		}
+	}
+
+	QVector<quint64> identifiers;
+	identifiers.reserve(sortedEntries.count());
+
+	QMultiMap<QDateTime, quint64>::const_iterator iterator(sortedEntries.constEnd());
+
+	while (iterator != sortedEntries.constBegin())
+	{
+		--iterator;
+
+		identifiers.append(iterator.value());
+
+		m_entries[iterator.value()] = qMakePair(parent.row(), iterator.key());
+	}
+
+	if (identifiers.isEmpty())
+	{
+		group.isPopulated = true;
+
+		return;
+	}
+
+	beginInsertRows(parent, 0, (identifiers.count() - 1));
+
+	group.entries = identifiers;
+	group.isPopulated = true;
+
+	endInsertRows();
+}
+
+void HistoryContentsModel::insertEntry(HistoryEntryItem *entry)
+{
+	const quint64 identifier(entry->data(HistoryModel::IdentifierRole).toULongLong());
+	const QDateTime time(entry->data(HistoryModel::TimeVisitedRole).toDateTime());
+	const int groupIndex(getGroup(time.date()));
+
+	if (identifier == 0 || groupIndex < 0)
+	{
+		return;
+	}
+
+	HistoryGroup &group(m_groups[groupIndex]);
+
+	if (!group.isPopulated)
+	{
+		if (group.amount > 0)
+		{
+			return;
+		}
+
+		group.isPopulated = true;
+	}
+
+	if (m_entries.contains(identifier))
+	{
+		return;
+	}
+
+	const int row(getInsertionRow(groupIndex, time));
+
+	beginInsertRows(index(groupIndex, 0), row, row);
+
+	group.entries.insert(row, identifier);
+
+	m_entries[identifier] = qMakePair(groupIndex, time);
+
+	endInsertRows();
+}
+
+void HistoryContentsModel::removeEntry(quint64 identifier)
+{
+	const int row(getRow(identifier));
+
+	if (row < 0)
+	{
+		m_entries.remove(identifier);
+
+		return;
+	}
+
+	const int group(m_entries.value(identifier).first);
+
+	beginRemoveRows(index(group, 0), row, row);
+
+	m_groups[group].entries.remove(row);
+
+	m_entries.remove(identifier);
+
+	endRemoveRows();
+}
+
+void HistoryContentsModel::updateAmounts()
+{
+	HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+
+	for (int i = 0; i < m_groups.count(); ++i)
+	{
+		m_groups[i].amount = (m_groups.at(i).isPopulated ? m_groups.at(i).entries.count() : model->getEntriesAmount(m_groups.at(i).from, m_groups.at(i).to));
+	}
+}
+
+void HistoryContentsModel::addEntry(HistoryEntryItem *entry)
+{
+	if (entry)
+	{
+		insertEntry(entry);
+		updateAmounts();
+	}
+}
+
+void HistoryContentsModel::modifyEntry(HistoryEntryItem *entry)
+{
+	if (!entry)
+	{
+		return;
+	}
+
+	const quint64 identifier(entry->data(HistoryModel::IdentifierRole).toULongLong());
+	const QDateTime time(entry->data(HistoryModel::TimeVisitedRole).toDateTime());
+
+	if (m_entries.contains(identifier) && m_entries[identifier].second == time)
+	{
+		const int row(getRow(identifier));
+
+		if (row >= 0)
+		{
+			const QModelIndex parent(index(m_entries[identifier].first, 0));
+
+			emit dataChanged(index(row, 0, parent), index(row, 2, parent));
+
+			return;
+		}
+	}
+
+	removeEntry(identifier);
+	insertEntry(entry);
+	updateAmounts();
+}
+
+void HistoryContentsModel::removeEntry(HistoryEntryItem *entry)
+{
+	if (entry)
+	{
+		removeEntry(entry->data(HistoryModel::IdentifierRole).toULongLong());
+		updateAmounts();
+	}
+}
+
+QModelIndex HistoryContentsModel::index(int row, int column, const QModelIndex &parent) const
+{
+	if (row < 0 || column < 0 || column >= 3)
+	{
+		return QModelIndex();
+	}
+
+	if (!parent.isValid())
+	{
+		return ((row < m_groups.count()) ? createIndex(row, column, quintptr(0)) : QModelIndex());
+	}
+
+	if (parent.internalId() == 0 && parent.column() == 0 && parent.row() < m_groups.count() && row < m_groups.at(parent.row()).entries.count())
+	{
+		return createIndex(row, column, quintptr(parent.row() + 1));
+	}
+
+	return QModelIndex();
+}
+
+QModelIndex HistoryContentsModel::parent(const QModelIndex &index) const
+{
+	if (!index.isValid() || index.internalId() == 0)
+	{
+		return QModelIndex();
+	}
+
+	return createIndex(static_cast<int>(index.internalId() - 1), 0, quintptr(0));
+}
+
+QVariant HistoryContentsModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid())
+	{
+		return QVariant();
+	}
+
+	if (index.internalId() == 0)
+	{
+		if (index.column() == 0 && index.row() < m_groups.count())
+		{
+			if (role == Qt::DisplayRole)
+			{
+				return m_groups.at(index.row()).title;
+			}
+
+			if (role == Qt::DecorationRole)
+			{
+				return ThemesManager::getIcon(QLatin1String("inode-directory"));
+			}
+		}
+
+		return QVariant();
+	}
+
+	const int group(static_cast<int>(index.internalId() - 1));
+
+	if (group >= m_groups.count() || index.row() >= m_groups.at(group).entries.count())
+	{
+		return QVariant();
+	}
+
+	const quint64 identifier(m_groups.at(group).entries.at(index.row()));
+	HistoryEntryItem *entry(HistoryManager::getEntry(identifier));
+
+	if (!entry)
+	{
+		return QVariant();
+	}
+
+	switch (index.column())
+	{
+		case 0:
+			if (role == Qt::DisplayRole)
+			{
+				return entry->data(HistoryModel::UrlRole).toUrl().toDisplayString().replace(QLatin1String("%23"), QString(QLatin1Char('#')));
+			}
+
+			if (role == Qt::DecorationRole)
+			{
+				return (entry->icon().isNull() ? ThemesManager::getIcon(QLatin1String("text-html")) : entry->icon());
+			}
+
+			if (role == Qt::UserRole)
+			{
+				return identifier;
+			}
+
+			break;
+		case 1:
+			if (role == Qt::DisplayRole)
+			{
+				return (entry->data(HistoryModel::TitleRole).isNull() ? tr("(Untitled)") : entry->data(HistoryModel::TitleRole).toString());
+			}
+
+			break;
+		case 2:
+			if (role == Qt::DisplayRole)
+			{
+				return Utils::formatDateTime(entry->data(HistoryModel::TimeVisitedRole).toDateTime());
+			}
+
+			break;
+		default:
+			break;
+	}
+
+	return QVariant();
+}
+
+QVariant HistoryContentsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+	{
+		switch (section)
+		{
+			case 0:
+				return tr("Address");
+			case 1:
+				return tr("Title");
+			case 2:
+				return tr("Date");
+			default:
+				break;
+		}
+	}
+
+	return QAbstractItemModel::headerData(section, orientation, role);
+}
+
+Qt::ItemFlags HistoryContentsModel::flags(const QModelIndex &index) const
+{
+	if (!index.isValid())
+	{
+		return Qt::NoItemFlags;
+	}
 
-	const QStringList groups({tr("Today"), tr("Yesterday"), tr("Earlier This Week"), tr("Previous Week"), tr("Earlier This Month"), tr("Earlier This Year"), tr("Older")});
+	return ((index.internalId() == 0) ? (Qt::ItemIsSelectable | Qt::ItemIsEnabled) : (Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemNeverHasChildren));
+}
 
-	for (int i = 0; i < groups.count(); ++i)
+int HistoryContentsModel::rowCount(const QModelIndex &parent) const
+{
+	if (!parent.isValid())
 	{
-		m_model->appendRow(new QStandardItem(ThemesManager::getIcon(QLatin1String("inode-directory")), groups.at(i)));
+		return m_groups.count();
 	}
 
-	m_model->setHorizontalHeaderLabels(QStringList({tr("Address"), tr("Title"), tr("Date")}));
-	m_model->setSortRole(Qt::DisplayRole);
+	if (parent.internalId() == 0 && parent.column() == 0 && parent.row() < m_groups.count())
+	{
+		return m_groups.at(parent.row()).entries.count();
+	}
+
+	return 0;
+}
+
+int HistoryContentsModel::columnCount(const QModelIndex &parent) const
+{
+	Q_UNUSED(parent)
+
+	return 3;
+}
 
+int HistoryContentsModel::getGroup(const QDate &date) const
+{
+	for (int i = 0; i < m_groups.count(); ++i)
+	{
+		if (!m_groups.at(i).from.isValid() || date >= m_groups.at(i).from)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int HistoryContentsModel::getRow(quint64 identifier) const
+{
+	if (!m_entries.contains(identifier))
+	{
+		return -1;
+	}
+
+	const QPair<int, QDateTime> location(m_entries[identifier]);
+	const QVector<quint64> &entries(m_groups.at(location.first).entries);
+
+	for (int row = getInsertionRow(location.first, location.second); row < entries.count(); ++row)
+	{
+		if (entries.at(row) == identifier)
+		{
+			return row;
+		}
+
+		if (m_entries.value(entries.at(row)).second != location.second)
+		{
+			break;
+		}
+	}
+
+	return -1;
+}
+
+int HistoryContentsModel::getInsertionRow(int group, const QDateTime &time) const
+{
+	const QVector<quint64> &entries(m_groups.at(group).entries);
+	int low(0);
+	int high(entries.count());
+
+	while (low < high)
+	{
+		const int middle((low + high) / 2);
+
+		if (m_entries.value(entries.at(middle)).second > time)
+		{
+			low = (middle + 1);
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+bool HistoryContentsModel::canFetchMore(const QModelIndex &parent) const
+{
+	return (parent.isValid() && parent.internalId() == 0 && parent.column() == 0 && parent.row() < m_groups.count() && !m_groups.at(parent.row()).isPopulated && m_groups.at(parent.row()).amount > 0);
+}
+
+bool HistoryContentsModel::hasChildren(const QModelIndex &parent) const
+{
+	if (!parent.isValid())
+	{
+		return !m_groups.isEmpty();
+	}
+
+	if (parent.internalId() == 0 && parent.column() == 0 && parent.row() < m_groups.count())
+	{
+		return (m_groups.at(parent.row()).amount > 0);
+	}
+
+	return false;
+}
+
+HistoryContentsWidget::HistoryContentsWidget(Window *window) : ContentsWidget(window),
+	m_model(new HistoryContentsModel(this)),
+	m_isLoading(true),
+	m_ui(new Ui::HistoryContentsWidget)
+{
+	m_ui->setupUi(this);
 	m_ui->historyViewWidget->setViewMode(ItemViewWidget::TreeViewMode);
 	m_ui->historyViewWidget->setModel(m_model, true);
 	m_ui->historyViewWidget->installEventFilter(this);
 	m_ui->historyViewWidget->viewport()->installEventFilter(this);
 	m_ui->filterLineEdit->installEventFilter(this);
 
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		m_ui->historyViewWidget->setRowHidden(i, m_model->invisibleRootItem()->index(), true);
-	}
+	updateGroups();
 
 	QTimer::singleShot(100, this, SLOT(populateEntries()));
 
 	connect(HistoryManager::getBrowsingHistoryModel(), SIGNAL(cleared()), this, SLOT(populateEntries()));
-	connect(HistoryManager::getBrowsingHistoryModel(), SIGNAL(entryAdded(HistoryEntryItem*)), this, SLOT(addEntry(HistoryEntryItem*)));
-	connect(HistoryManager::getBrowsingHistoryModel(), SIGNAL(entryModified(HistoryEntryItem*)), this, SLOT(modifyEntry(HistoryEntryItem*)));
-	connect(HistoryManager::getBrowsingHistoryModel(), SIGNAL(entryRemoved(HistoryEntryItem*)), this, SLOT(removeEntry(HistoryEntryItem*)));
 	connect(HistoryManager::getInstance(), SIGNAL(dayChanged()), this, SLOT(populateEntries()));
+	connect(m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(updateGroups()));
+	connect(m_model, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(updateGroups()));
 	connect(m_ui->filterLineEdit, SIGNAL(textChanged(QString)), m_ui->historyViewWidget, SLOT(setFilterString(QString)));
 	connect(m_ui->historyViewWidget, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(openEntry(QModelIndex)));
 	connect(m_ui->historyViewWidget, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(showContextMenu(QPoint)));
@@ -115,26 +549,9 @@ void HistoryContentsWidget::print(QPrinter *printer)
 
 void HistoryContentsWidget::populateEntries()
 {
-	const QDate date(QDate::currentDate());
-	const QList<QDate> dates({date, date.addDays(-1), date.addDays(-7), date.addDays(-14), date.addDays(-30), date.addDays(-365)});
+	m_model->reload();
 
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		QStandardItem *groupItem(m_model->item(i, 0));
-
-		if (groupItem)
-		{
-			groupItem->setData(dates.value(i, QDate()), Qt::UserRole);
-			groupItem->removeRows(0, groupItem->rowCount());
-		}
-	}
-
-	HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
-
-	for (int i = 0; i < model->rowCount(); ++i)
-	{
-		addEntry(dynamic_cast<HistoryEntryItem*>(model->item(i, 0)));
-	}
+	updateGroups();
 
 	const QString expandBranches(SettingsManager::getValue(QLatin1String("History/ExpandBranches")).toString());
 
@@ -144,7 +561,7 @@ void HistoryContentsWidget::populateEntries()
 		{
 			const QModelIndex index(m_model->index(i, 0));
 
-			if (m_model->rowCount(index) > 0)
+			if (m_model->hasChildren(index))
 			{
 				m_ui->historyViewWidget->expand(m_ui->historyViewWidget->getProxyModel()->mapFromSource(index));
 
@@ -162,49 +579,30 @@ void HistoryContentsWidget::populateEntries()
 	emit loadingStateChanged(WindowsManager::FinishedLoadingState);
 }
 
-void HistoryContentsWidget::addEntry(HistoryEntryItem *entry)
+void HistoryContentsWidget::updateGroups()
 {
-	if (!entry || entry->data(HistoryModel::IdentifierRole).toULongLong() == 0 || findEntry(entry->data(HistoryModel::IdentifierRole).toULongLong()))
-	{
-		return;
-	}
-
-	QStandardItem *groupItem(NULL);
+	bool hasShownGroup(false);
 
 	for (int i = 0; i < m_model->rowCount(); ++i)
 	{
-		groupItem = m_model->item(i, 0);
+		const QModelIndex index(m_ui->historyViewWidget->getProxyModel()->mapFromSource(m_model->index(i, 0)));
+		const bool isHidden(!m_model->hasChildren(m_model->index(i, 0)));
 
-		if (groupItem && (entry->data(HistoryModel::TimeVisitedRole).toDateTime().date() >= groupItem->data(Qt::UserRole).toDate() || !groupItem->data(Qt::UserRole).toDate().isValid()))
+		if (m_ui->historyViewWidget->isRowHidden(index.row(), index.parent()) != isHidden)
 		{
-			break;
-		}
+			m_ui->historyViewWidget->setRowHidden(index.row(), index.parent(), isHidden);
 
-		groupItem = NULL;
+			hasShownGroup = (hasShownGroup || !isHidden);
+		}
 	}
 
-	if (!groupItem)
-	{
-		return;
-	}
-
-	QList<QStandardItem*> entryItems({new QStandardItem((entry->icon().isNull() ? ThemesManager::getIcon(QLatin1String("text-html")) : entry->icon()), entry->data(HistoryModel::UrlRole).toUrl().toDisplayString().replace(QLatin1String("%23"), QString(QLatin1Char('#')))), new QStandardItem(entry->data(HistoryModel::TitleRole).isNull() ? tr("(Untitled)") : entry->data(HistoryModel::TitleRole).toString()), new QStandardItem(Utils::formatDateTime(entry->data(HistoryModel::TimeVisitedRole).toDateTime()))});
-	entryItems[0]->setData(entry->data(HistoryModel::IdentifierRole).toULongLong(), Qt::UserRole);
-	entryItems[0]->setFlags(entryItems[0]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[1]->setFlags(entryItems[1]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[2]->setFlags(entryItems[2]->flags() | Qt::ItemNeverHasChildren);
-
-	groupItem->appendRow(entryItems);
-
-	m_ui->historyViewWidget->setRowHidden(groupItem->row(), groupItem->index().parent(), false);
-
-	if (sender() && groupItem->rowCount() == 1 && SettingsManager::getValue(QLatin1String("History/ExpandBranches")).toString() == QLatin1String("first"))
+	if (sender() && hasShownGroup && SettingsManager::getValue(QLatin1String("History/ExpandBranches")).toString() == QLatin1String("first"))
 	{
 		for (int i = 0; i < m_model->rowCount(); ++i)
 		{
 			const QModelIndex index(m_model->index(i, 0));
 
-			if (m_model->rowCount(index) > 0)
+			if (m_model->hasChildren(index))
 			{
 				m_ui->historyViewWidget->expand(m_ui->historyViewWidget->getProxyModel()->mapFromSource(index));
 
@@ -214,53 +612,6 @@ void HistoryContentsWidget::addEntry(HistoryEntryItem *entry)
 	}
 }
 
-void HistoryContentsWidget::modifyEntry(HistoryEntryItem *entry)
-{
-	if (!entry || entry->data(HistoryModel::IdentifierRole).toULongLong() == 0)
-	{
-		return;
-	}
-
-	QStandardItem *entryItem(findEntry(entry->data(HistoryModel::IdentifierRole).toULongLong()));
-
-	if (!entryItem)
-	{
-		addEntry(entry);
-
-		return;
-	}
-
-	entryItem->setIcon(entry->icon().isNull() ? ThemesManager::getIcon(QLatin1String("text-html")) : entry->icon());
-	entryItem->setText(entry->data(HistoryModel::UrlRole).toUrl().toDisplayString());
-	entryItem->parent()->child(entryItem->row(), 1)->setText(entry->data(HistoryModel::TitleRole).isNull() ? tr("(Untitled)") : entry->data(HistoryModel::TitleRole).toString());
-	entryItem->parent()->child(entryItem->row(), 2)->setText(Utils::formatDateTime(entry->data(HistoryModel::TimeVisitedRole).toDateTime()));
-}
-
-void HistoryContentsWidget::removeEntry(HistoryEntryItem *entry)
-{
-	if (!entry || entry->data(HistoryModel::IdentifierRole).toULongLong() == 0)
-	{
-		return;
-	}
-
-	QStandardItem *entryItem(findEntry(entry->data(HistoryModel::IdentifierRole).toULongLong()));
-
-	if (entryItem)
-	{
-		QStandardItem *groupItem(entryItem->parent());
-
-		if (groupItem)
-		{
-			m_model->removeRow(entryItem->row(), groupItem->index());
-
-			if (groupItem->rowCount() == 0)
-			{
-				m_ui->historyViewWidget->setRowHidden(groupItem->row(), m_model->invisibleRootItem()->index(), true);
-			}
-		}
-	}
-}
-
 void HistoryContentsWidget::removeEntry()
 {
 	const quint64 entry(getEntry(m_ui->historyViewWidget->currentIndex()));
@@ -273,33 +624,24 @@ void HistoryContentsWidget::removeEntry()
 
 void HistoryContentsWidget::removeDomainEntries()
 {
-	QStandardItem *domainItem(findEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
+	HistoryEntryItem *domainEntry(HistoryManager::getEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
 
-	if (!domainItem)
+	if (!domainEntry)
 	{
 		return;
 	}
 
-	const QString host(QUrl(domainItem->text()).host());
+	HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+	const QString host(domainEntry->data(HistoryModel::UrlRole).toUrl().host());
 	QList<quint64> entries;
 
-	for (int i = 0; i < m_model->rowCount(); ++i)
+	for (int i = (model->rowCount() - 1); i >= 0; --i)
 	{
-		QStandardItem *groupItem(m_model->item(i, 0));
+		QStandardItem *entryItem(model->item(i, 0));
 
-		if (!groupItem)
+		if (entryItem && host == entryItem->data(HistoryModel::UrlRole).toUrl().host())
 		{
-			continue;
-		}
-
-		for (int j = (groupItem->rowCount() - 1); j >= 0; --j)
-		{
-			QStandardItem *entryItem(groupItem->child(j, 0));
-
-			if (entryItem && host == QUrl(entryItem->text()).host())
-			{
-				entries.append(entryItem->data(Qt::UserRole).toULongLong());
-			}
+			entries.append(entryItem->data(HistoryModel::IdentifierRole).toULongLong());
 		}
 	}
 
@@ -310,7 +652,7 @@ void HistoryContentsWidget::openEntry(const QModelIndex &index)
 {
 	const QModelIndex entryIndex(index.isValid() ? index : m_ui->historyViewWidget->currentIndex());
 
-	if (!entryIndex.isValid() || entryIndex.parent() == m_model->invisibleRootItem()->index())
+	if (!entryIndex.isValid() || !entryIndex.parent().isValid())
 	{
 		return;
 	}
@@ -327,21 +669,22 @@ void HistoryContentsWidget::openEntry(const QModelIndex &index)
 
 void HistoryContentsWidget::bookmarkEntry()
 {
-	QStandardItem *entryItem(findEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
+	const QModelIndex index(m_ui->historyViewWidget->currentIndex());
+	HistoryEntryItem *entry(HistoryManager::getEntry(getEntry(index)));
 
-	if (entryItem)
+	if (entry)
 	{
-		emit requestedAddBookmark(QUrl(entryItem->text()), m_ui->historyViewWidget->currentIndex().sibling(m_ui->historyViewWidget->currentIndex().row(), 1).data(Qt::DisplayRole).toString(), QString());
+		emit requestedAddBookmark(entry->data(HistoryModel::UrlRole).toUrl(), index.sibling(index.row(), 1).data(Qt::DisplayRole).toString(), QString());
 	}
 }
 
 void HistoryContentsWidget::copyEntryLink()
 {
-	QStandardItem *entryItem(findEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
+	const QModelIndex index(m_ui->historyViewWidget->currentIndex());
 
-	if (entryItem)
+	if (getEntry(index) > 0)
 	{
-		QApplication::clipboard()->setText(entryItem->text());
+		QApplication::clipboard()->setText(index.sibling(index.row(), 0).data(Qt::DisplayRole).toString());
 	}
 }
 
@@ -371,29 +714,6 @@ void HistoryContentsWidget::showContextMenu(const QPoint &point)
 	menu.exec(m_ui->historyViewWidget->mapToGlobal(point));
 }
 
-QStandardItem* HistoryContentsWidget::findEntry(quint64 identifier)
-{
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		QStandardItem *groupItem(m_model->item(i, 0));
-
-		if (groupItem)
-		{
-			for (int j = 0; j < groupItem->rowCount(); ++j)
-			{
-				QStandardItem *entryItem(groupItem->child(j, 0));
-
-				if (entryItem && entryItem->data(Qt::UserRole).toULongLong() == identifier)
-				{
-					return entryItem;
-				}
-			}
-		}
-	}
-
-	return NULL;
-}
-
 QString HistoryContentsWidget::getTitle() const
 {
 	return tr("History");
@@ -421,7 +741,7 @@ WindowsManager::LoadingState HistoryContentsWidget::getLoadingState() const
 
 quint64 HistoryContentsWidget::getEntry(const QModelIndex &index) const
 {
-	return ((index.isValid() && index.parent().isValid() && index.parent().parent() == m_model->invisibleRootItem()->index()) ? index.sibling(index.row(), 0).data(Qt::UserRole).toULongLong() : -1);
+	return ((index.isValid() && index.parent().isValid() && !index.parent().parent().isValid()) ? index.sibling(index.row(), 0).data(Qt::UserRole).toULongLong() : 0);
 }
 
 bool HistoryContentsWidget::eventFilter(QObject *object, QEvent *event)
@@ -452,7 +772,7 @@ bool HistoryContentsWidget::eventFilter(QObject *object, QEvent *event)
 		{
 			const QModelIndex entryIndex(m_ui->historyViewWidget->currentIndex());
 
-			if (!entryIndex.isValid() || entryIndex.parent() == m_model->invisibleRootItem()->index())
+			if (!entryIndex.isValid() || !entryIndex.parent().isValid())
 			{
 				return ContentsWidget::eventFilter(object, event);
 			}
@@ -23,7 +23,7 @@
 #include "../../../core/HistoryManager.h"
 #include "../../../ui/ContentsWidget.h"
 
-#include <QtGui/QStandardItemModel>
+#include <QtCore/QAbstractItemModel>
 
 namespace Otter
 {
@@ -35,6 +35,55 @@ namespace Ui
 
 class Window;
 
+class HistoryContentsModel : public QAbstractItemModel
+{
+	Q_OBJECT
+
+public:
+	explicit HistoryContentsModel(QObject *parent = NULL);
+
+	void reload();
+	void fetchMore(const QModelIndex &parent);
+	QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+	QModelIndex parent(const QModelIndex &index) const;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+	Qt::ItemFlags flags(const QModelIndex &index) const;
+	int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const;
+	bool canFetchMore(const QModelIndex &parent) const;
+	bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
+
+protected:
+	struct HistoryGroup
+	{
+		QString title;
+		QDate from;
+		QDate to;
+		QVector<quint64> entries;
+		int amount;
+		bool isPopulated;
+
+		HistoryGroup() : amount(0), isPopulated(false) {}
+	};
+
+	void insertEntry(HistoryEntryItem *entry);
+	void removeEntry(quint64 identifier);
+	void updateAmounts();
+	int getGroup(const QDate &date) const;
+	int getRow(quint64 identifier) const;
+	int getInsertionRow(int group, const QDateTime &time) const;
+
+protected slots:
+	void addEntry(HistoryEntryItem *entry);
+	void modifyEntry(HistoryEntryItem *entry);
+	void removeEntry(HistoryEntryItem *entry);
+
+private:
+	QVector<HistoryGroup> m_groups;
+	QHash<quint64, QPair<int, QDateTime> > m_entries;
+};
+
 class HistoryContentsWidget : public ContentsWidget
 {
 	Q_OBJECT
@@ -56,14 +105,11 @@ public slots:
 
 protected:
 	void changeEvent(QEvent *event);
-	QStandardItem* findEntry(quint64 identifier);
 	quint64 getEntry(const QModelIndex &index) const;
 
 protected slots:
 	void populateEntries();
-	void addEntry(HistoryEntryItem *entry);
-	void modifyEntry(HistoryEntryItem *entry);
-	void removeEntry(HistoryEntryItem *entry);
+	void updateGroups();
 	void removeEntry();
 	void removeDomainEntries();
 	void openEntry(const QModelIndex &index = QModelIndex());
@@ -72,7 +118,7 @@ protected slots:
 	void showContextMenu(const QPoint &point);
 
 private:
-	QStandardItemModel *m_model;
+	HistoryContentsModel *m_model;
 	bool m_isLoading;
 	Ui::HistoryContentsWidget *m_ui;
 };
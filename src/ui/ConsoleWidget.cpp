@@ -25,20 +25,205 @@
 
 #include "ui_ConsoleWidget.h"
 
+#include <QtCore/QTimerEvent>
 #include <QtGui/QClipboard>
 #include <QtWidgets/QActionGroup>
 #include <QtWidgets/QMenu>
 
+#define CONSOLEWIDGET_RATES_INTERVAL 1000
+
 namespace Otter
 {
 
+ConsoleMessagesModel::ConsoleMessagesModel(QObject *parent) : QAbstractItemModel(parent),
+	m_firstSequence(Console::getFirstSequence()),
+	m_lastSequence(Console::getLastSequence())
+{
+	connect(Console::getInstance(), SIGNAL(messagesAdded()), this, SLOT(updateMessages()));
+}
+
+void ConsoleMessagesModel::clear()
+{
+	beginResetModel();
+
+	m_firstSequence = Console::getLastSequence();
+	m_lastSequence = m_firstSequence;
+
+	endResetModel();
+}
+
+void ConsoleMessagesModel::updateMessages()
+{
+	const quint64 firstSequence(qMax(m_firstSequence, Console::getFirstSequence()));
+	const quint64 lastSequence(Console::getLastSequence());
+
+	if (firstSequence > m_firstSequence)
+	{
+		const quint64 removedSequence(qMin(firstSequence, m_lastSequence));
+
+		if (removedSequence > m_firstSequence)
+		{
+			const int amount(rowCount());
+
+			beginRemoveRows(QModelIndex(), (amount - static_cast<int>(removedSequence - m_firstSequence)), (amount - 1));
+
+			m_firstSequence = removedSequence;
+
+			endRemoveRows();
+		}
+
+		m_firstSequence = firstSequence;
+		m_lastSequence = qMax(m_lastSequence, firstSequence);
+	}
+
+	if (lastSequence > m_lastSequence)
+	{
+		beginInsertRows(QModelIndex(), 0, static_cast<int>(lastSequence - m_lastSequence - 1));
+
+		m_lastSequence = lastSequence;
+
+		endInsertRows();
+	}
+}
+
+ConsoleMessage ConsoleMessagesModel::getMessage(int row) const
+{
+	if (row < 0 || row >= rowCount())
+	{
+		return ConsoleMessage();
+	}
+
+	return Console::getMessage(m_lastSequence - 1 - row);
+}
+
+QModelIndex ConsoleMessagesModel::index(int row, int column, const QModelIndex &parent) const
+{
+	if (column != 0 || row < 0)
+	{
+		return QModelIndex();
+	}
+
+	if (parent.isValid())
+	{
+		return ((row == 0 && !parent.parent().isValid() && !getMessage(parent.row()).note.isEmpty()) ? createIndex(row, column, static_cast<quintptr>(m_lastSequence - parent.row())) : QModelIndex());
+	}
+
+	return ((row < rowCount()) ? createIndex(row, column, static_cast<quintptr>(0)) : QModelIndex());
+}
+
+QModelIndex ConsoleMessagesModel::parent(const QModelIndex &index) const
+{
+	if (!index.isValid() || index.internalId() == 0)
+	{
+		return QModelIndex();
+	}
+
+	const quint64 sequence(index.internalId() - 1);
+
+	if (sequence < m_firstSequence || sequence >= m_lastSequence)
+	{
+		return QModelIndex();
+	}
+
+	return createIndex(static_cast<int>(m_lastSequence - 1 - sequence), 0, static_cast<quintptr>(0));
+}
+
+QVariant ConsoleMessagesModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid())
+	{
+		return QVariant();
+	}
+
+	if (index.internalId() > 0)
+	{
+		return ((role == Qt::DisplayRole) ? Console::getMessage(index.internalId() - 1).note : QVariant());
+	}
+
+	if (role != Qt::DisplayRole && role != Qt::DecorationRole)
+	{
+		return QVariant();
+	}
+
+	const ConsoleMessage message(getMessage(index.row()));
+
+	if (role == Qt::DecorationRole)
+	{
+		switch (message.level)
+		{
+			case ErrorMessageLevel:
+				return ThemesManager::getIcon(QLatin1String("dialog-error"));
+			case WarningMessageLevel:
+				return ThemesManager::getIcon(QLatin1String("dialog-warning"));
+			default:
+				break;
+		}
+
+		return ThemesManager::getIcon(QLatin1String("dialog-information"));
+	}
+
+	QString category;
+
+	switch (message.category)
+	{
+		case NetworkMessageCategory:
+			category = ConsoleWidget::tr("Network");
+
+			break;
+		case SecurityMessageCategory:
+			category = ConsoleWidget::tr("Security");
+
+			break;
+		case JavaScriptMessageCategory:
+			category = ConsoleWidget::tr("JS");
+
+			break;
+		default:
+			category = ConsoleWidget::tr("Other");
+
+			break;
+	}
+
+	QString entry(QStringLiteral("[%1] %2").arg(message.time.toString()).arg(category));
+
+	if (!message.source.isEmpty())
+	{
+		entry.append(QStringLiteral(" - %1").arg(message.source + ((message.line > 0) ? QStringLiteral(":%1").arg(message.line) : QString())));
+	}
+
+	return entry;
+}
+
+int ConsoleMessagesModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.isValid())
+	{
+		return ((parent.internalId() == 0 && !getMessage(parent.row()).note.isEmpty()) ? 1 : 0);
+	}
+
+	return static_cast<int>(m_lastSequence - m_firstSequence);
+}
+
+int ConsoleMessagesModel::columnCount(const QModelIndex &parent) const
+{
+	Q_UNUSED(parent)
+
+	return 1;
+}
+
 ConsoleWidget::ConsoleWidget(QWidget *parent) : QWidget(parent),
 	m_model(NULL),
 	m_messageScopes(AllTabsScope | OtherSourcesScope),
+	m_ratesTimer(0),
 	m_ui(new Ui::ConsoleWidget)
 {
 	m_ui->setupUi(this);
 
+	for (int i = OtherMessageCategory; i <= JavaScriptMessageCategory; ++i)
+	{
+		m_messagesAmounts[i] = Console::getMessagesAmount(static_cast<MessageCategory>(i));
+	}
+
 	QMenu *menu(new QMenu(m_ui->scopeButton));
 	QAction *allTabsAction(menu->addAction(tr("All Tabs")));
 	allTabsAction->setData(AllTabsScope);
@@ -78,6 +263,14 @@ ConsoleWidget::~ConsoleWidget()
 	delete m_ui;
 }
 
+void ConsoleWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_ratesTimer)
+	{
+		updateMessagesRates();
+	}
+}
+
 void ConsoleWidget::showEvent(QShowEvent *event)
 {
 	if (!m_model)
@@ -89,93 +282,72 @@ void ConsoleWidget::showEvent(QShowEvent *event)
 			connect(mainWindow->getWindowsManager(), SIGNAL(currentWindowChanged(quint64)), this, SLOT(filterCategories()));
 		}
 
-		m_model = new QStandardItemModel(this);
-		m_model->setSortRole(Qt::UserRole);
+		m_model = new ConsoleMessagesModel(this);
+
+		m_ui->consoleView->setModel(m_model);
 
-		const QList<ConsoleMessage> messages(Console::getMessages());
+		filterCategories();
 
-		for (int i = 0; i < messages.count(); ++i)
-		{
-			addMessage(messages.at(i));
-		}
+		connect(m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(filterAddedMessages(QModelIndex,int,int)));
+	}
 
-		m_ui->consoleView->setModel(m_model);
+	if (m_ratesTimer == 0)
+	{
+		updateMessagesRates();
 
-		connect(Console::getInstance(), SIGNAL(messageAdded(ConsoleMessage)), this, SLOT(addMessage(ConsoleMessage)));
+		m_ratesTimer = startTimer(CONSOLEWIDGET_RATES_INTERVAL);
 	}
 
 	QWidget::showEvent(event);
 }
 
-void ConsoleWidget::addMessage(const ConsoleMessage &message)
+void ConsoleWidget::hideEvent(QHideEvent *event)
 {
-	if (!m_model)
+	if (m_ratesTimer != 0)
 	{
-		return;
-	}
-
-	QIcon icon;
-	QString category;
+		killTimer(m_ratesTimer);
 
-	switch (message.level)
-	{
-		case ErrorMessageLevel:
-			icon = ThemesManager::getIcon(QLatin1String("dialog-error"));
+		m_ratesTimer = 0;
+	}
 
-			break;
-		case WarningMessageLevel:
-			icon = ThemesManager::getIcon(QLatin1String("dialog-warning"));
+	QWidget::hideEvent(event);
+}
 
-			break;
-		default:
-			icon = ThemesManager::getIcon(QLatin1String("dialog-information"));
+void ConsoleWidget::updateMessagesRates()
+{
+	QToolButton *buttons[4];
+	buttons[OtherMessageCategory] = m_ui->otherButton;
+	buttons[NetworkMessageCategory] = m_ui->networkButton;
+	buttons[SecurityMessageCategory] = m_ui->securityButton;
+	buttons[JavaScriptMessageCategory] = m_ui->javaScriptButton;
 
-			break;
-	}
+	const double interval(CONSOLEWIDGET_RATES_INTERVAL / 1000.0);
 
-	switch (message.category)
+	for (int i = OtherMessageCategory; i <= JavaScriptMessageCategory; ++i)
 	{
-		case NetworkMessageCategory:
-			category = tr("Network");
-
-			break;
-		case SecurityMessageCategory:
-			category = tr("Security");
-
-			break;
-		case JavaScriptMessageCategory:
-			category = tr("JS");
+		const int amount(Console::getMessagesAmount(static_cast<MessageCategory>(i)));
 
-			break;
-		default:
-			category = tr("Other");
+		buttons[i]->setToolTip(tr("Messages: %1\nMessages per second: %2").arg(amount).arg(((m_ratesTimer == 0) ? 0 : ((amount - m_messagesAmounts[i]) / interval)), 0, 'f', 1));
 
-			break;
+		m_messagesAmounts[i] = amount;
 	}
+}
 
-	const QString source(message.source + ((message.line > 0) ? QStringLiteral(":%1").arg(message.line) : QString()));
-	QString entry(QStringLiteral("[%1] %2").arg(message.time.toString()).arg(category));
-
-	if (!message.source.isEmpty())
+void ConsoleWidget::filterAddedMessages(const QModelIndex &parent, int start, int end)
+{
+	if (parent.isValid())
 	{
-		entry.append(QStringLiteral(" - %1").arg(source));
+		return;
 	}
 
-	QStandardItem *item(new QStandardItem(icon, entry));
-	item->setData(message.time.toTime_t(), Qt::UserRole);
-	item->setData(message.category, (Qt::UserRole + 1));
-	item->setData(source, (Qt::UserRole + 2));
-	item->setData(message.window, (Qt::UserRole + 3));
+	const QString filter(m_ui->filterLineEdit->text());
+	const QList<MessageCategory> categories(getCategories());
+	const quint64 currentWindow(getCurrentWindow());
 
-	if (!message.note.isEmpty())
+	for (int i = start; i <= end; ++i)
 	{
-		item->appendRow(new QStandardItem(message.note));
+		applyFilters(i, filter, categories, currentWindow);
 	}
-
-	m_model->appendRow(item);
-	m_model->sort(0, Qt::DescendingOrder);
-
-	applyFilters(item, m_ui->filterLineEdit->text(), getCategories(), getCurrentWindow());
 }
 
 void ConsoleWidget::clear()
@@ -193,6 +365,11 @@ void ConsoleWidget::copyText()
 
 void ConsoleWidget::filterCategories()
 {
+	if (!m_model)
+	{
+		return;
+	}
+
 	QMenu *menu(qobject_cast<QMenu*>(sender()));
 
 	if (menu)
@@ -215,7 +392,7 @@ void ConsoleWidget::filterCategories()
 
 	for (int i = 0; i < m_model->rowCount(); ++i)
 	{
-		applyFilters(m_model->item(i, 0), m_ui->filterLineEdit->text(), categories, currentWindow);
+		applyFilters(i, m_ui->filterLineEdit->text(), categories, currentWindow);
 	}
 }
 
@@ -228,32 +405,26 @@ void ConsoleWidget::filterMessages(const QString &filter)
 
 		for (int i = 0; i < m_model->rowCount(); ++i)
 		{
-			applyFilters(m_model->item(i, 0), filter, categories, currentWindow);
+			applyFilters(i, filter, categories, currentWindow);
 		}
 	}
 }
 
-void ConsoleWidget::applyFilters(QStandardItem *item, const QString &filter, const QList<MessageCategory> &categories, quint64 currentWindow)
+void ConsoleWidget::applyFilters(int row, const QString &filter, const QList<MessageCategory> &categories, quint64 currentWindow)
 {
-	if (!item)
-	{
-		return;
-	}
-
+	const ConsoleMessage message(m_model->getMessage(row));
 	bool matched(true);
 
-	if (!filter.isEmpty() && !(item->data(Qt::UserRole + 2).toString().contains(filter, Qt::CaseInsensitive) || (item->child(0, 0) && item->child(0, 0)->text().contains(filter, Qt::CaseInsensitive))))
+	if (!filter.isEmpty() && !((message.source + ((message.line > 0) ? QStringLiteral(":%1").arg(message.line) : QString())).contains(filter, Qt::CaseInsensitive) || message.note.contains(filter, Qt::CaseInsensitive)))
 	{
 		matched = false;
 	}
 	else
 	{
-		const quint64 window(item->data(Qt::UserRole + 3).toULongLong());
-
-		matched = (((window == 0 && m_messageScopes.testFlag(OtherSourcesScope)) || (window > 0 && ((window == currentWindow && m_messageScopes.testFlag(CurrentTabScope)) || m_messageScopes.testFlag(AllTabsScope)))) && categories.contains(static_cast<MessageCategory>(item->data(Qt::UserRole + 1).toInt())));
+		matched = (((message.window == 0 && m_messageScopes.testFlag(OtherSourcesScope)) || (message.window > 0 && ((message.window == currentWindow && m_messageScopes.testFlag(CurrentTabScope)) || m_messageScopes.testFlag(AllTabsScope)))) && categories.contains(message.category));
 	}
 
-	m_ui->consoleView->setRowHidden(item->row(), m_ui->consoleView->rootIndex(), !matched);
+	m_ui->consoleView->setRowHidden(row, m_ui->consoleView->rootIndex(), !matched);
 }
 
 void ConsoleWidget::showContextMenu(const QPoint position)
@@ -20,7 +20,7 @@
 #ifndef OTTER_CONSOLEWIDGET_H
 #define OTTER_CONSOLEWIDGET_H
 
-#include <QtGui/QStandardItemModel>
+#include <QtCore/QAbstractItemModel>
 #include <QtWidgets/QWidget>
 
 #include "../core/Console.h"
@@ -33,6 +33,29 @@ namespace Ui
 	class ConsoleWidget;
 }
 
+class ConsoleMessagesModel : public QAbstractItemModel
+{
+	Q_OBJECT
+
+public:
+	explicit ConsoleMessagesModel(QObject *parent = NULL);
+
+	void clear();
+	ConsoleMessage getMessage(int row) const;
+	QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+	QModelIndex parent(const QModelIndex &index) const;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const;
+
+protected slots:
+	void updateMessages();
+
+private:
+	quint64 m_firstSequence;
+	quint64 m_lastSequence;
+};
+
 class ConsoleWidget : public QWidget
 {
 	Q_OBJECT
@@ -52,13 +75,16 @@ protected:
 
 	Q_DECLARE_FLAGS(MessagesScopes, MessagesScope)
 
+	void timerEvent(QTimerEvent *event);
 	void showEvent(QShowEvent *event);
-	void applyFilters(QStandardItem *item, const QString &filter, const QList<MessageCategory> &categories, quint64 currentWindow);
+	void hideEvent(QHideEvent *event);
+	void updateMessagesRates();
+	void applyFilters(int row, const QString &filter, const QList<MessageCategory> &categories, quint64 currentWindow);
 	QList<MessageCategory> getCategories() const;
 	quint64 getCurrentWindow();
 
 protected slots:
-	void addMessage(const ConsoleMessage &message);
+	void filterAddedMessages(const QModelIndex &parent, int start, int end);
 	void clear();
 	void copyText();
 	void filterCategories();
@@ -66,8 +92,10 @@ protected slots:
 	void showContextMenu(const QPoint position);
 
 private:
-	QStandardItemModel *m_model;
+	ConsoleMessagesModel *m_model;
 	MessagesScopes m_messageScopes;
+	int m_messagesAmounts[4];
+	int m_ratesTimer;
 	Ui::ConsoleWidget *m_ui;
 };
 
@@ -203,7 +203,8 @@ ItemViewWidget::ItemViewWidget(QWidget *parent) : QTreeView(parent),
 	m_dropRow(-1),
 	m_canGatherExpanded(false),
 	m_isModified(false),
-	m_isInitialized(false)
+	m_isInitialized(false),
+	m_isUpdatingFilter(false)
 {
 	m_treeIndentation = indentation();
 
@@ -508,12 +509,123 @@ void ItemViewWidget::updateDropSelection()
 
 void ItemViewWidget::updateFilter()
 {
-	if (model())
+	if (!model() || m_isUpdatingFilter)
 	{
+		return;
+	}
+
+	m_isUpdatingFilter = true;
+
+	const QString filter(m_filterString.toCaseFolded());
+	const bool isNarrowing(!m_foldedFilterString.isEmpty() && filter.contains(m_foldedFilterString));
+
+	if (!filter.isEmpty() && !isNarrowing)
+	{
+		QList<QModelIndex> indexes;
+
 		for (int i = 0; i < model()->rowCount(); ++i)
 		{
-			applyFilter(model()->index(i, 0));
+			indexes.append(model()->index(i, 0));
 		}
+
+		while (!indexes.isEmpty())
+		{
+			const QModelIndex index(indexes.takeLast());
+
+			if (index.flags().testFlag(Qt::ItemNeverHasChildren))
+			{
+				continue;
+			}
+
+			if (model()->canFetchMore(index))
+			{
+				model()->fetchMore(index);
+			}
+
+			for (int i = 0; i < model()->rowCount(index); ++i)
+			{
+				indexes.append(index.child(i, 0));
+			}
+		}
+	}
+
+	m_foldedFilterString = filter;
+
+	const bool updatesEnabled(this->updatesEnabled());
+
+	setUpdatesEnabled(false);
+
+	for (int i = 0; i < model()->rowCount(); ++i)
+	{
+		applyFilter(model()->index(i, 0), isNarrowing);
+	}
+
+	setUpdatesEnabled(updatesEnabled);
+
+	if (filter.isEmpty())
+	{
+		clearFilterCache();
+	}
+
+	m_isUpdatingFilter = false;
+}
+
+void ItemViewWidget::clearFilterCache()
+{
+	m_filterCache = FilterNode();
+	m_foldedFilterString.clear();
+}
+
+void ItemViewWidget::markFilterDataModified(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+	if (m_filterString.isEmpty() || !topLeft.isValid() || !bottomRight.isValid())
+	{
+		return;
+	}
+
+	FilterNode *parentNode(getFilterNode(topLeft.parent(), false));
+
+	if (!parentNode)
+	{
+		return;
+	}
+
+	for (int i = topLeft.row(); i <= bottomRight.row() && i < parentNode->children.count(); ++i)
+	{
+		FilterNode &node(parentNode->children[i]);
+		node.text.clear();
+		node.state = UnknownFilterState;
+		node.hasText = false;
+	}
+}
+
+void ItemViewWidget::markFilterRowsInserted(const QModelIndex &parent, int first, int last)
+{
+	if (m_filterString.isEmpty())
+	{
+		return;
+	}
+
+	FilterNode *parentNode(getFilterNode(parent, false));
+
+	if (parentNode && first < parentNode->children.count())
+	{
+		parentNode->children.insert(first, (last - first + 1), FilterNode());
+	}
+}
+
+void ItemViewWidget::markFilterRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+	if (m_filterString.isEmpty())
+	{
+		return;
+	}
+
+	FilterNode *parentNode(getFilterNode(parent, false));
+
+	if (parentNode && first < parentNode->children.count())
+	{
+		parentNode->children.remove(first, (qMin(last, (parentNode->children.count() - 1)) - first + 1));
 	}
 }
 
@@ -586,6 +698,8 @@ void ItemViewWidget::setFilterString(const QString filter)
 void ItemViewWidget::setFilterRoles(const QSet<int> &roles)
 {
 	m_filterRoles = roles;
+
+	clearFilterCache();
 }
 
 void ItemViewWidget::setData(const QModelIndex &index, const QVariant &value, int role)
@@ -621,6 +735,8 @@ void ItemViewWidget::setModel(QAbstractItemModel *model, bool useSortProxy)
 
 	m_sourceModel = qobject_cast<QStandardItemModel*>(model);
 
+	clearFilterCache();
+
 	QTreeView::setModel(usedModel);
 
 	if (!model)
@@ -628,6 +744,13 @@ void ItemViewWidget::setModel(QAbstractItemModel *model, bool useSortProxy)
 		return;
 	}
 
+	connect(usedModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)), this, SLOT(markFilterDataModified(QModelIndex,QModelIndex)));
+	connect(usedModel, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(markFilterRowsInserted(QModelIndex,int,int)));
+	connect(usedModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(markFilterRowsRemoved(QModelIndex,int,int)));
+	connect(usedModel, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)), this, SLOT(clearFilterCache()));
+	connect(usedModel, SIGNAL(layoutChanged()), this, SLOT(clearFilterCache()));
+	connect(usedModel, SIGNAL(modelReset()), this, SLOT(clearFilterCache()));
+
 	if (!model->parent())
 	{
 		model->setParent(this);
@@ -728,7 +851,67 @@ bool ItemViewWidget::canMoveDown() const
 	return (currentRow >= 0 && m_sourceModel->rowCount() > 1 && currentRow < (m_sourceModel->rowCount() - 1));
 }
 
-bool ItemViewWidget::applyFilter(const QModelIndex &index)
+ItemViewWidget::FilterNode* ItemViewWidget::getFilterNode(const QModelIndex &index, bool canCreate)
+{
+	QVector<int> rows;
+
+	for (QModelIndex currentIndex(index); currentIndex.isValid(); currentIndex = currentIndex.parent())
+	{
+		rows.prepend(currentIndex.row());
+	}
+
+	FilterNode *node(&m_filterCache);
+
+	for (int i = 0; i < rows.count(); ++i)
+	{
+		if (rows.at(i) >= node->children.count())
+		{
+			if (!canCreate)
+			{
+				return NULL;
+			}
+
+			node->children.resize(rows.at(i) + 1);
+		}
+
+		node = &node->children[rows.at(i)];
+	}
+
+	return node;
+}
+
+QString ItemViewWidget::getFilterText(const QModelIndex &index) const
+{
+	QString text;
+	const int columnCount(model()->columnCount(index.parent()));
+
+	for (int i = 0; i < columnCount; ++i)
+	{
+		const QModelIndex childIndex(index.sibling(index.row(), i));
+
+		if (!childIndex.isValid())
+		{
+			continue;
+		}
+
+		QSet<int>::const_iterator iterator;
+
+		for (iterator = m_filterRoles.constBegin(); iterator != m_filterRoles.constEnd(); ++iterator)
+		{
+			const QString value(childIndex.data(*iterator).toString());
+
+			if (!value.isEmpty())
+			{
+				text.append(value.toCaseFolded());
+				text.append(QLatin1Char('\n'));
+			}
+		}
+	}
+
+	return text;
+}
+
+bool ItemViewWidget::applyFilter(const QModelIndex &index, bool isNarrowing)
 {
 	if (!model())
 	{
@@ -749,49 +932,47 @@ bool ItemViewWidget::applyFilter(const QModelIndex &index)
 
 		for (int i = 0; i < rowCount; ++i)
 		{
-			if (applyFilter(index.child(i, 0)))
+			if (applyFilter(index.child(i, 0), isNarrowing))
 			{
 				hasFound = true;
 			}
 		}
 	}
-	else
+	else if (!hasFound)
 	{
-		const int columnCount(index.parent().isValid() ? model()->rowCount(index.parent()) : model()->columnCount());
+		FilterNode *node(getFilterNode(index, true));
 
-		for (int i = 0; i < columnCount; ++i)
+		if (isNarrowing && node->state == UnmatchedFilterState)
 		{
-			const QModelIndex childIndex(index.sibling(index.row(), i));
+			return false;
+		}
 
-			if (!childIndex.isValid())
-			{
-				continue;
-			}
+		if (!node->hasText)
+		{
+			node->text = getFilterText(index);
+			node->hasText = true;
+		}
 
-			QSet<int>::iterator iterator;
+		hasFound = node->text.contains(m_foldedFilterString);
 
-			for (iterator = m_filterRoles.begin(); iterator != m_filterRoles.end(); ++iterator)
-			{
-				if (childIndex.data(*iterator).toString().contains(m_filterString, Qt::CaseInsensitive))
-				{
-					hasFound = true;
+		node->state = (hasFound ? MatchedFilterState : UnmatchedFilterState);
+	}
 
-					break;
-				}
-			}
+	const bool isHidden(!hasFound || (isFolder && !model()->hasChildren(index)));
 
-			if (hasFound)
-			{
-				break;
-			}
-		}
+	if (isRowHidden(index.row(), index.parent()) != isHidden)
+	{
+		setRowHidden(index.row(), index.parent(), isHidden);
 	}
 
-	setRowHidden(index.row(), index.parent(), (!hasFound || (isFolder && model()->rowCount(index) == 0)));
-
 	if (isFolder)
 	{
-		setExpanded(index, ((hasFound && !m_filterString.isEmpty()) || (m_filterString.isEmpty() && m_expandedBranches.contains(index))));
+		const bool shouldExpand((hasFound && !m_filterString.isEmpty()) || (m_filterString.isEmpty() && m_expandedBranches.contains(index)));
+
+		if (isExpanded(index) != shouldExpand)
+		{
+			setExpanded(index, shouldExpand);
+		}
 	}
 
 	return hasFound;
@@ -23,6 +23,7 @@
 #define OTTER_ITEMVIEWWIDGET_H
 
 #include <QtCore/QSortFilterProxyModel>
+#include <QtCore/QVector>
 #include <QtGui/QContextMenuEvent>
 #include <QtGui/QStandardItemModel>
 #include <QtWidgets/QHeaderView>
@@ -100,11 +101,30 @@ public slots:
 	void setFilterRoles(const QSet<int> &roles);
 
 protected:
+	enum FilterState
+	{
+		UnknownFilterState = 0,
+		MatchedFilterState,
+		UnmatchedFilterState
+	};
+
+	struct FilterNode
+	{
+		QString text;
+		QVector<FilterNode> children;
+		FilterState state;
+		bool hasText;
+
+		FilterNode() : state(UnknownFilterState), hasText(false) {}
+	};
+
 	void showEvent(QShowEvent *event);
 	void dropEvent(QDropEvent *event);
 	void startDrag(Qt::DropActions supportedActions);
 	void moveRow(bool up);
-	bool applyFilter(const QModelIndex &index);
+	FilterNode* getFilterNode(const QModelIndex &index, bool canCreate);
+	QString getFilterText(const QModelIndex &index) const;
+	bool applyFilter(const QModelIndex &index, bool isNarrowing);
 
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
@@ -113,14 +133,20 @@ protected slots:
 	void notifySelectionChanged();
 	void updateDropSelection();
 	void updateFilter();
+	void clearFilterCache();
+	void markFilterDataModified(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+	void markFilterRowsInserted(const QModelIndex &parent, int first, int last);
+	void markFilterRowsRemoved(const QModelIndex &parent, int first, int last);
 
 private:
 	HeaderViewWidget *m_headerWidget;
 	QStandardItemModel *m_sourceModel;
 	QSortFilterProxyModel *m_proxyModel;
 	QString m_filterString;
+	QString m_foldedFilterString;
 	QSet<QModelIndex> m_expandedBranches;
 	QSet<int> m_filterRoles;
+	FilterNode m_filterCache;
 	ViewMode m_viewMode;
 	Qt::SortOrder m_sortOrder;
 	int m_sortColumn;
@@ -129,6 +155,7 @@ private:
 	bool m_canGatherExpanded;
 	bool m_isModified;
 	bool m_isInitialized;
+	bool m_isUpdatingFilter;
 
 	static int m_treeIndentation;
 
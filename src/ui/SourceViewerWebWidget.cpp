@@ -410,7 +410,7 @@ void SourceViewerWebWidget::setContents(const QByteArray &contents, const QStrin
 		text = QString(contents);
 	}
 
-	m_sourceViewer->setPlainText(text);
+	m_sourceViewer->setContents(text);
 	m_sourceViewer->document()->setModified(false);
 }
 
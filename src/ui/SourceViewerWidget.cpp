@@ -20,20 +20,34 @@
 #include "SourceViewerWidget.h"
 #include "../core/SettingsManager.h"
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QMetaEnum>
+#include <QtCore/QTimerEvent>
 #include <QtGui/QPainter>
 #include <QtGui/QTextBlock>
 #include <QtWidgets/QScrollBar>
 
+#define SYNTAXHIGHLIGHTER_TIME_SLICE 10
+#define SYNTAXHIGHLIGHTER_VISIBLE_BLOCKS 200
+
 namespace Otter
 {
 
 QMap<SyntaxHighlighter::HighlightingSyntax, QMap<SyntaxHighlighter::HighlightingState, QTextCharFormat> > SyntaxHighlighter::m_formats;
 
-SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter(parent)
+SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter(parent),
+	m_watcher(new QFutureWatcher<QVector<int> >(this)),
+	m_firstVisibleBlock(0),
+	m_firstDirtyBlock(-1),
+	m_statesOffset(0),
+	m_nextBlock(0),
+	m_highlightTimer(0),
+	m_revision(-1),
+	m_isDeferred(false)
 {
 	if (m_formats[HtmlSyntax].isEmpty())
 	{
@@ -91,109 +105,523 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter
 
 		file.close();
 	}
+
+	connect(m_watcher, SIGNAL(finished()), this, SLOT(applyBlockStates()));
+	connect(parent, SIGNAL(contentsChange(int,int,int)), this, SLOT(markBlocksDirty(int)));
 }
 
-void SyntaxHighlighter::highlightBlock(const QString &text)
+void SyntaxHighlighter::timerEvent(QTimerEvent *event)
 {
-	QString buffer;
-	BlockData currentData;
-	HighlightingState previousState(static_cast<HighlightingState>(qMax(previousBlockState(), 0)));
-	HighlightingState currentState(previousState);
-	int previousStateBegin(0);
-	int currentStateBegin(0);
-	int position(0);
+	if (event->timerId() != m_highlightTimer)
+	{
+		return;
+	}
 
-	if (currentBlock().previous().userData())
+	if (document() && (document()->revision() != m_revision || document()->blockCount() != m_highlightedBlocks.count()))
 	{
-		currentData = *static_cast<BlockData*>(currentBlock().previous().userData());
+		const int firstDirtyBlock((m_firstDirtyBlock < 0) ? m_highlightedBlocks.count() : qMin(m_firstDirtyBlock, m_highlightedBlocks.count()));
+		QBitArray highlightedBlocks(document()->blockCount());
+
+		for (int i = 0; i < qMin(firstDirtyBlock, highlightedBlocks.count()); ++i)
+		{
+			highlightedBlocks.setBit(i, m_highlightedBlocks.testBit(i));
+		}
+
+		m_highlightedBlocks = highlightedBlocks;
+		m_nextBlock = qMin(m_nextBlock, firstDirtyBlock);
+		m_firstDirtyBlock = -1;
+		m_revision = document()->revision();
 	}
 
-	while (position < text.length())
+	const int amount(m_highlightedBlocks.count());
+
+	if (!document() || m_nextBlock >= amount)
 	{
-		buffer.append(text.at(position));
+		killTimer(m_highlightTimer);
+
+		m_highlightTimer = 0;
+		m_highlightedBlocks.clear();
+
+		return;
+	}
 
-		++position;
+	QElapsedTimer timer;
+	timer.start();
 
-		const bool isEndOfLine(position == text.length());
+	const int firstVisibleBlock(qBound(0, m_firstVisibleBlock, (amount - 1)));
+	const int lastVisibleBlock(qMin(amount, (firstVisibleBlock + SYNTAXHIGHLIGHTER_VISIBLE_BLOCKS)));
+	QTextBlock block(document()->findBlockByNumber(firstVisibleBlock));
 
-		if (currentState == NoState && text.at(position - 1) == QLatin1Char('<'))
+	for (int i = firstVisibleBlock; i < lastVisibleBlock && block.isValid(); ++i)
+	{
+		if (!m_highlightedBlocks.testBit(i))
 		{
-			currentState = KeywordState;
-			currentStateBegin = (position - 1);
+			rehighlightBlock(block);
 		}
-		else if ((currentState == KeywordState || currentState == DoctypeState) && text.at(position - 1) == QLatin1Char('>'))
+
+		block = block.next();
+	}
+
+	block = document()->findBlockByNumber(m_nextBlock);
+
+	while (block.isValid() && m_nextBlock < amount && timer.elapsed() < SYNTAXHIGHLIGHTER_TIME_SLICE)
+	{
+		if (!m_highlightedBlocks.testBit(m_nextBlock))
 		{
-			currentState = NoState;
-			currentStateBegin = position;
+			rehighlightBlock(block);
 		}
-		else if (currentState == AttributeState && text.length() > position && text.at(position) == QLatin1Char('>'))
+
+		block = block.next();
+
+		++m_nextBlock;
+	}
+}
+
+void SyntaxHighlighter::beginUpdate()
+{
+	if (m_highlightTimer > 0)
+	{
+		killTimer(m_highlightTimer);
+
+		m_highlightTimer = 0;
+	}
+
+	m_highlightedBlocks.clear();
+	m_isDeferred = true;
+}
+
+void SyntaxHighlighter::endUpdate(const QString &text)
+{
+	m_revision = (document() ? document()->revision() : -1);
+	m_firstDirtyBlock = -1;
+	m_statesOffset = 0;
+
+	m_watcher->setFuture(QtConcurrent::run(&SyntaxHighlighter::getBlockStates, text, -1));
+}
+
+void SyntaxHighlighter::applyBlockStates()
+{
+	const QVector<int> states(m_watcher->result());
+
+	if (!document())
+	{
+		m_isDeferred = false;
+
+		return;
+	}
+
+	const int amount(m_statesOffset + states.count());
+	const bool isModified(document()->revision() != m_revision);
+	int firstDirtyBlock(qMin(amount, document()->blockCount()));
+
+	if (isModified)
+	{
+		firstDirtyBlock = qMin(firstDirtyBlock, ((m_firstDirtyBlock < 0) ? m_statesOffset : m_firstDirtyBlock));
+	}
+	else if (firstDirtyBlock < document()->blockCount() && firstDirtyBlock <= m_statesOffset)
+	{
+		m_isDeferred = false;
+
+		rehighlight();
+
+		return;
+	}
+
+	QTextBlock block(document()->findBlockByNumber(m_statesOffset));
+
+	for (int i = m_statesOffset; (i < firstDirtyBlock && block.isValid()); ++i)
+	{
+		block.setUserState(states.at(i - m_statesOffset));
+		block = block.next();
+	}
+
+	if (firstDirtyBlock < document()->blockCount())
+	{
+		const QTextBlock previousBlock(document()->findBlockByNumber(firstDirtyBlock - 1));
+		QString text;
+
+		block = document()->findBlockByNumber(firstDirtyBlock);
+
+		while (block.isValid())
 		{
-			currentState = KeywordState;
-			currentStateBegin = position;
+			text.append(block.text());
+
+			block = block.next();
+
+			if (block.isValid())
+			{
+				text.append(QLatin1Char('\n'));
+			}
 		}
-		else if (currentState == KeywordState && buffer == QLatin1String("!DOCTYPE"))
+
+		m_revision = document()->revision();
+		m_firstDirtyBlock = -1;
+		m_statesOffset = firstDirtyBlock;
+
+		m_watcher->setFuture(QtConcurrent::run(&SyntaxHighlighter::getBlockStates, text, (previousBlock.isValid() ? previousBlock.userState() : -1)));
+
+		return;
+	}
+
+	m_isDeferred = false;
+	m_highlightedBlocks = QBitArray(document()->blockCount());
+	m_nextBlock = 0;
+
+	if (m_highlightTimer == 0)
+	{
+		m_highlightTimer = startTimer(0);
+	}
+}
+
+void SyntaxHighlighter::highlightBlock(const QString &text)
+{
+	if (m_isDeferred)
+	{
+		return;
+	}
+
+	setCurrentBlockState(highlightLine(text.constData(), text.length(), previousBlockState(), this));
+
+	if (!m_highlightedBlocks.isEmpty())
+	{
+		const int block(currentBlock().blockNumber());
+
+		if (block >= 0 && block < m_highlightedBlocks.count())
 		{
-			currentState = DoctypeState;
+			m_highlightedBlocks.setBit(block);
 		}
-		else if (currentState == KeywordState && buffer == QLatin1String("!--"))
+	}
+}
+
+void SyntaxHighlighter::markBlocksDirty(int position)
+{
+	const int block(document() ? document()->findBlock(position).blockNumber() : -1);
+
+	if (block >= 0 && (m_firstDirtyBlock < 0 || block < m_firstDirtyBlock))
+	{
+		m_firstDirtyBlock = block;
+	}
+}
+
+void SyntaxHighlighter::setFirstVisibleBlock(int block)
+{
+	m_firstVisibleBlock = block;
+}
+
+QVector<int> SyntaxHighlighter::getBlockStates(const QString &text, int state)
+{
+	QVector<int> states;
+	const QChar *data(text.constData());
+	const int length(text.length());
+	int lineStart(0);
+
+	for (int i = 0; i <= length; ++i)
+	{
+		if (i < length && data[i] != QLatin1Char('\n') && data[i] != QLatin1Char('\r') && data[i] != QChar::ParagraphSeparator)
 		{
-			currentState = CommentState;
+			continue;
 		}
-		else if (currentState == CommentState && buffer.endsWith(QLatin1String("-->")))
+
+		state = highlightLine((data + lineStart), (i - lineStart), state);
+
+		states.append(state);
+
+		if (i + 1 < length && data[i] == QLatin1Char('\r') && data[i + 1] == QLatin1Char('\n'))
 		{
-			currentState = NoState;
-			currentStateBegin = position;
+			++i;
 		}
-		else if (currentState == KeywordState && (text.at(position - 1) == QLatin1Char('-') || text.at(position - 1).isLetter() || text.at(position - 1).isNumber()) && (position == 1 || (position > 1 && text.at(position - 2).isSpace())))
+
+		lineStart = (i + 1);
+	}
+
+	return states;
+}
+
+int SyntaxHighlighter::highlightLine(const QChar *text, int length, int state, SyntaxHighlighter *highlighter)
+{
+	// Block state layout: bits 0-3 hold current state, bits 4-7 state to restore after quoted value,
+	// bits 8-9 quote character, bits 10-11 current syntax and bits 12-13 syntax of embedded block opened by current tag
+	if (state < 0)
+	{
+		state = (HtmlSyntax << 10);
+	}
+
+	HighlightingState currentState(static_cast<HighlightingState>(state & 15));
+	HighlightingState savedState(static_cast<HighlightingState>((state >> 4) & 15));
+	HighlightingSyntax currentSyntax(static_cast<HighlightingSyntax>((state >> 10) & 3));
+	HighlightingSyntax pendingSyntax(static_cast<HighlightingSyntax>((state >> 12) & 3));
+	int quote((state >> 8) & 3);
+	int begin(0);
+	const QChar quotes[4] = {QChar(), QLatin1Char('\''), QLatin1Char('"'), QLatin1Char('`')};
+
+	for (int i = 0; i < length; ++i)
+	{
+		const QChar character(text[i]);
+		HighlightingSyntax nextSyntax(currentSyntax);
+		HighlightingState nextState(currentState);
+		int boundary(i);
+		bool isReprocessing(false);
+
+		if (currentSyntax == HtmlSyntax)
 		{
-			currentState = AttributeState;
-			currentStateBegin = (position - 1);
+			switch (currentState)
+			{
+				case NoState:
+					if (character == QLatin1Char('<'))
+					{
+						if (matchesText(text, length, (i + 1), "!--"))
+						{
+							nextState = CommentState;
+
+							i += 3;
+						}
+						else if (matchesText(text, length, (i + 1), "!doctype"))
+						{
+							nextState = DoctypeState;
+						}
+						else
+						{
+							nextState = KeywordState;
+
+							if (matchesText(text, length, (i + 1), "style", true))
+							{
+								pendingSyntax = CssSyntax;
+							}
+							else if (matchesText(text, length, (i + 1), "script", true))
+							{
+								pendingSyntax = JavaScriptSyntax;
+							}
+							else
+							{
+								pendingSyntax = NoSyntax;
+							}
+						}
+					}
+					else if (character == QLatin1Char('&'))
+					{
+						nextState = EntityState;
+					}
+
+					break;
+				case EntityState:
+					if (character == QLatin1Char(';'))
+					{
+						nextState = NoState;
+						boundary = (i + 1);
+					}
+					else if (!character.isLetterOrNumber() && character != QLatin1Char('#'))
+					{
+						nextState = NoState;
+						isReprocessing = true;
+					}
+
+					break;
+				case CommentState:
+					if (matchesText(text, length, i, "-->"))
+					{
+						nextState = NoState;
+						boundary = (i + 3);
+
+						i += 2;
+					}
+
+					break;
+				case DoctypeState:
+				case KeywordState:
+					if (character == QLatin1Char('>'))
+					{
+						nextState = NoState;
+						boundary = (i + 1);
+
+						if (currentState == KeywordState && pendingSyntax != NoSyntax)
+						{
+							nextSyntax = pendingSyntax;
+							pendingSyntax = NoSyntax;
+						}
+					}
+					else if (character == QLatin1Char('\'') || character == QLatin1Char('"'))
+					{
+						nextState = ValueState;
+						savedState = currentState;
+						quote = ((character == QLatin1Char('"')) ? 2 : 1);
+					}
+					else if (currentState == KeywordState && (character.isLetterOrNumber() || character == QLatin1Char('-')) && (i == 0 || text[i - 1].isSpace()))
+					{
+						nextState = AttributeState;
+					}
+
+					break;
+				case AttributeState:
+					if (!(character.isLetterOrNumber() || character == QLatin1Char('-') || character == QLatin1Char(':')))
+					{
+						nextState = KeywordState;
+						isReprocessing = true;
+					}
+
+					break;
+				case ValueState:
+					if (character == quotes[quote])
+					{
+						nextState = savedState;
+						boundary = (i + 1);
+						savedState = NoState;
+						quote = 0;
+					}
+
+					break;
+				default:
+					break;
+			}
 		}
-		else if (currentState == AttributeState && !(text.at(position - 1) == QLatin1Char('-') || text.at(position - 1).isLetter() || text.at(position - 1).isNumber()))
+		else
 		{
-			currentState = KeywordState;
-			currentStateBegin = (position - 1);
+			const bool isJavaScript(currentSyntax == JavaScriptSyntax);
+
+			switch (currentState)
+			{
+				case CommentState:
+					if (matchesText(text, length, i, "*/"))
+					{
+						nextState = NoState;
+						boundary = (i + 2);
+
+						++i;
+					}
+
+					break;
+				case ValueState:
+					if (character == QLatin1Char('\\'))
+					{
+						++i;
+					}
+					else if (character == quotes[quote])
+					{
+						nextState = NoState;
+						boundary = (i + 1);
+						quote = 0;
+					}
+
+					break;
+				default:
+					if (character == QLatin1Char('<') && matchesText(text, length, (i + 1), (isJavaScript ? "/script" : "/style"), true))
+					{
+						nextSyntax = HtmlSyntax;
+						nextState = KeywordState;
+					}
+					else if (matchesText(text, length, i, "/*"))
+					{
+						nextState = CommentState;
+
+						++i;
+					}
+					else if (isJavaScript && matchesText(text, length, i, "//"))
+					{
+						if (highlighter)
+						{
+							highlighter->setFormat(begin, (i - begin), m_formats.value(currentSyntax).value(currentState));
+							highlighter->setFormat(i, (length - i), m_formats.value(currentSyntax).value(CommentState));
+						}
+
+						begin = length;
+						i = length;
+					}
+					else if (character == QLatin1Char('\'') || character == QLatin1Char('"') || (isJavaScript && character == QLatin1Char('`')))
+					{
+						nextState = ValueState;
+						quote = ((character == QLatin1Char('\'')) ? 1 : ((character == QLatin1Char('"')) ? 2 : 3));
+					}
+					else if (isJavaScript && (character.isLetter() || character == QLatin1Char('_') || character == QLatin1Char('$')) && (i == 0 || !(text[i - 1].isLetterOrNumber() || text[i - 1] == QLatin1Char('_') || text[i - 1] == QLatin1Char('$'))))
+					{
+						int end(i + 1);
+
+						while (end < length && (text[end].isLetterOrNumber() || text[end] == QLatin1Char('_') || text[end] == QLatin1Char('$')))
+						{
+							++end;
+						}
+
+						if (isJavaScriptKeyword((text + i), (end - i)))
+						{
+							if (highlighter)
+							{
+								highlighter->setFormat(begin, (i - begin), m_formats.value(currentSyntax).value(currentState));
+								highlighter->setFormat(i, (end - i), m_formats.value(currentSyntax).value(KeywordState));
+							}
+
+							begin = end;
+						}
+
+						i = (end - 1);
+					}
+
+					break;
+			}
 		}
-		else if ((currentState == KeywordState || currentState == DoctypeState || currentState == AttributeState) && (text.at(position - 1) == QLatin1Char('\'') || text.at(position - 1) == QLatin1Char('"')))
+
+		if (nextState != currentState || nextSyntax != currentSyntax)
 		{
-			currentData.context = text.at(position - 1);
-			currentData.state = currentState;
-			currentState = ValueState;
-			currentStateBegin = (position - 1);
+			if (highlighter && boundary > begin)
+			{
+				highlighter->setFormat(begin, (boundary - begin), m_formats.value(currentSyntax).value(currentState));
+			}
+
+			begin = boundary;
+			currentState = nextState;
+			currentSyntax = nextSyntax;
 		}
-		else if (currentState == ValueState && text.at(position - 1) == currentData.context)
+
+		if (isReprocessing)
 		{
-			currentState = currentData.state;
-			currentStateBegin = position;
-			currentData.context = QString();
-			currentData.state = NoState;
+			--i;
 		}
+	}
 
-		if (previousState != currentState || isEndOfLine)
-		{
-			setFormat(previousStateBegin, (position - previousStateBegin), m_formats[HtmlSyntax][previousState]);
+	if (highlighter && length > begin)
+	{
+		highlighter->setFormat(begin, (length - begin), m_formats.value(currentSyntax).value(currentState));
+	}
 
-			if (isEndOfLine)
-			{
-				setFormat(currentStateBegin, (position - currentStateBegin), m_formats[HtmlSyntax][currentState]);
-			}
+	return (currentState | (savedState << 4) | (quote << 8) | (currentSyntax << 10) | (pendingSyntax << 12));
+}
 
-			buffer = QString();
-			previousState = currentState;
-			previousStateBegin = currentStateBegin;
+bool SyntaxHighlighter::matchesText(const QChar *text, int length, int position, const char *pattern, bool isTag)
+{
+	for (int i = 0; pattern[i] != '\0'; ++i, ++position)
+	{
+		if (position >= length || text[position].toLower() != QLatin1Char(pattern[i]))
+		{
+			return false;
 		}
 	}
 
-	if (!currentData.context.isEmpty())
+	return (!isTag || position >= length || !text[position].isLetterOrNumber());
+}
+
+bool SyntaxHighlighter::isJavaScriptKeyword(const QChar *text, int length)
+{
+	static const char *keywords[] = {"break", "case", "catch", "class", "const", "continue", "debugger", "default", "delete", "do", "else", "export", "extends", "false", "finally", "for", "function", "if", "import", "in", "instanceof", "let", "new", "null", "return", "super", "switch", "this", "throw", "true", "try", "typeof", "undefined", "var", "void", "while", "with", "yield"};
+
+	if (length < 2 || length > 10)
 	{
-		BlockData *nextBlockData(new BlockData());
-		nextBlockData->context = currentData.context;
-		nextBlockData->state = currentData.state;
+		return false;
+	}
+
+	for (unsigned int i = 0; i < (sizeof(keywords) / sizeof(keywords[0])); ++i)
+	{
+		const char *keyword(keywords[i]);
+		int j(0);
+
+		while (j < length && keyword[j] != '\0' && text[j] == QLatin1Char(keyword[j]))
+		{
+			++j;
+		}
 
-		setCurrentBlockUserData(nextBlockData);
+		if (j == length && keyword[j] == '\0')
+		{
+			return true;
+		}
 	}
 
-	setCurrentBlockState(currentState);
+	return false;
 }
 
 MarginWidget::MarginWidget(SourceViewerWidget *parent) : QWidget(parent),
@@ -324,12 +752,11 @@ bool MarginWidget::event(QEvent *event)
 }
 
 SourceViewerWidget::SourceViewerWidget(QWidget *parent) : QPlainTextEdit(parent),
+	m_highlighter(new SyntaxHighlighter(document())),
 	m_marginWidget(NULL),
 	m_findFlags(WebWidget::NoFlagsFind),
 	m_zoom(100)
 {
-	new SyntaxHighlighter(document());
-
 	setZoom(SettingsManager::getValue(QLatin1String("Content/DefaultZoom")).toInt());
 	optionChanged(QLatin1String("Interface/ShowScrollBars"), SettingsManager::getValue(QLatin1String("Interface/ShowScrollBars")));
 	optionChanged(QLatin1String("SourceViewer/ShowLineNumbers"), SettingsManager::getValue(QLatin1String("SourceViewer/ShowLineNumbers")));
@@ -337,6 +764,7 @@ SourceViewerWidget::SourceViewerWidget(QWidget *parent) : QPlainTextEdit(parent)
 
 	connect(this, SIGNAL(textChanged()), this, SLOT(updateSelection()));
 	connect(this, SIGNAL(cursorPositionChanged()), this, SLOT(updateTextCursor()));
+	connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(updateHighlighting()));
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
 }
 
@@ -452,6 +880,22 @@ void SourceViewerWidget::updateSelection()
 	setExtraSelections(extraSelections);
 }
 
+void SourceViewerWidget::updateHighlighting()
+{
+	m_highlighter->setFirstVisibleBlock(firstVisibleBlock().blockNumber());
+}
+
+void SourceViewerWidget::setContents(const QString &contents)
+{
+	m_highlighter->beginUpdate();
+
+	setPlainText(contents);
+
+	m_highlighter->endUpdate(contents);
+
+	updateHighlighting();
+}
+
 void SourceViewerWidget::setZoom(int zoom)
 {
 	if (zoom != m_zoom)
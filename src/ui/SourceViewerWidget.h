@@ -22,6 +22,8 @@
 
 #include "WebWidget.h"
 
+#include <QtCore/QBitArray>
+#include <QtCore/QFutureWatcher>
 #include <QtGui/QSyntaxHighlighter>
 #include <QtWidgets/QPlainTextEdit>
 
@@ -38,7 +40,9 @@ public:
 	enum HighlightingSyntax
 	{
 		NoSyntax = 0,
-		HtmlSyntax = 1
+		HtmlSyntax = 1,
+		CssSyntax = 2,
+		JavaScriptSyntax = 3
 	};
 
 	enum HighlightingState
@@ -52,22 +56,35 @@ public:
 		CommentState = 6
 	};
 
-	struct BlockData : public QTextBlockUserData
-	{
-		QString context;
-		HighlightingSyntax currentSyntax;
-		HighlightingSyntax previousSyntax;
-		HighlightingState state;
-
-		BlockData() : currentSyntax(HtmlSyntax), previousSyntax(HtmlSyntax), state(NoState) {}
-	};
-
 	explicit SyntaxHighlighter(QTextDocument *parent);
 
+	void beginUpdate();
+	void endUpdate(const QString &text);
+	void setFirstVisibleBlock(int block);
+	static QVector<int> getBlockStates(const QString &text, int state = -1);
+
 protected:
+	void timerEvent(QTimerEvent *event);
 	void highlightBlock(const QString &text);
+	static int highlightLine(const QChar *text, int length, int state, SyntaxHighlighter *highlighter = NULL);
+	static bool matchesText(const QChar *text, int length, int position, const char *pattern, bool isTag = false);
+	static bool isJavaScriptKeyword(const QChar *text, int length);
+
+protected slots:
+	void applyBlockStates();
+	void markBlocksDirty(int position);
 
 private:
+	QFutureWatcher<QVector<int> > *m_watcher;
+	QBitArray m_highlightedBlocks;
+	int m_firstVisibleBlock;
+	int m_firstDirtyBlock;
+	int m_statesOffset;
+	int m_nextBlock;
+	int m_highlightTimer;
+	int m_revision;
+	bool m_isDeferred;
+
 	static QMap<HighlightingSyntax, QMap<HighlightingState, QTextCharFormat> > m_formats;
 };
 
@@ -103,6 +120,7 @@ class SourceViewerWidget : public QPlainTextEdit
 public:
 	explicit SourceViewerWidget(QWidget *parent = NULL);
 
+	void setContents(const QString &contents);
 	void setZoom(int zoom);
 	int getZoom() const;
 	bool findText(const QString &text, WebWidget::FindFlags flags = WebWidget::NoFlagsFind);
@@ -116,8 +134,10 @@ protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
 	void updateTextCursor();
 	void updateSelection();
+	void updateHighlighting();
 
 private:
+	SyntaxHighlighter *m_highlighter;
 	MarginWidget *m_marginWidget;
 	QString m_findText;
 	QTextCursor m_findTextAnchor;
@@ -32,7 +32,7 @@
 #include <QtCore/QtMath>
 #include <QtCore/QTimer>
 #include <QtGui/QContextMenuEvent>
-#include <QtGui/QMovie>
+#include <QtGui/QImageReader>
 #include <QtGui/QPainter>
 #include <QtGui/QStatusTipEvent>
 #include <QtWidgets/QStyle>
@@ -58,6 +58,9 @@ TabBarWidget::TabBarWidget(QWidget *parent) : QTabBar(parent),
 	m_clickedTab(-1),
 	m_hoveredTab(-1),
 	m_previewTimer(0),
+	m_throbberTimer(0),
+	m_throbberStep(0),
+	m_throbberDelay(100),
 	m_showCloseButton(SettingsManager::getValue(QLatin1String("TabBar/ShowCloseButton")).toBool()),
 	m_showUrlIcon(SettingsManager::getValue(QLatin1String("TabBar/ShowUrlIcon")).toBool()),
 	m_enablePreviews(SettingsManager::getValue(QLatin1String("TabBar/EnablePreviews")).toBool())
@@ -87,6 +90,7 @@ TabBarWidget::TabBarWidget(QWidget *parent) : QTabBar(parent),
 
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
 	connect(this, SIGNAL(currentChanged(int)), this, SLOT(currentTabChanged(int)));
+	connect(this, SIGNAL(tabMoved(int,int)), this, SLOT(moveTabState(int,int)));
 }
 
 void TabBarWidget::timerEvent(QTimerEvent *event)
@@ -99,6 +103,53 @@ void TabBarWidget::timerEvent(QTimerEvent *event)
 
 		showPreview(tabAt(mapFromGlobal(QCursor::pos())));
 	}
+	else if (event->timerId() == m_throbberTimer)
+	{
+		++m_throbberStep;
+
+		bool isLoading(false);
+		const bool isShown(isVisible());
+		const QRect visibleRectangle(rect());
+
+		for (int i = 0; i < m_tabs.count(); ++i)
+		{
+			const WindowsManager::LoadingState loadingState(m_tabs.at(i).loadingState);
+
+			if (loadingState != WindowsManager::DelayedLoadingState && loadingState != WindowsManager::OngoingLoadingState)
+			{
+				continue;
+			}
+
+			isLoading = true;
+
+			if (!isShown)
+			{
+				break;
+			}
+
+			QLabel *label(qobject_cast<QLabel*>(tabButton(i, m_iconButtonPosition)));
+
+			if (!label || !label->isVisible() || !tabRect(i).intersects(visibleRectangle))
+			{
+				continue;
+			}
+
+			const QPixmap frame(getThrobberFrame(loadingState));
+
+			if (!label->pixmap() || label->pixmap()->cacheKey() != frame.cacheKey())
+			{
+				label->setPixmap(frame);
+			}
+		}
+
+		if (!isLoading)
+		{
+			killTimer(m_throbberTimer);
+
+			m_throbberTimer = 0;
+			m_throbberStep = 0;
+		}
+	}
 }
 
 void TabBarWidget::resizeEvent(QResizeEvent *event)
@@ -309,6 +360,9 @@ void TabBarWidget::tabLayoutChange()
 
 void TabBarWidget::tabInserted(int index)
 {
+	m_tabs.insert(index, TabState());
+
+	updateTabIndexes((index + 1));
 	setMaximumSize(QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
 
 	QTabBar::tabInserted(index);
@@ -325,7 +379,7 @@ void TabBarWidget::tabInserted(int index)
 		setTabButton(index, m_iconButtonPosition, NULL);
 	}
 
-	if (m_showCloseButton || getTabProperty(index, QLatin1String("isPinned"), false).toBool())
+	if (m_showCloseButton || m_tabs.at(index).isPinned)
 	{
 		QLabel *label(new QLabel());
 		label->setFixedSize(QSize(16, 16));
@@ -341,6 +395,18 @@ void TabBarWidget::tabInserted(int index)
 
 void TabBarWidget::tabRemoved(int index)
 {
+	if (index >= 0 && index < m_tabs.count())
+	{
+		if (m_tabs.at(index).window)
+		{
+			m_tabIndexes.remove(m_tabs.at(index).window.data());
+		}
+
+		m_tabs.remove(index);
+
+		updateTabIndexes(index);
+	}
+
 	QTabBar::tabRemoved(index);
 
 	if (count() == 0)
@@ -381,11 +447,23 @@ void TabBarWidget::tabHovered(int index)
 
 void TabBarWidget::addTab(int index, Window *window)
 {
-	insertTab(index, window->getTitle());
+	index = insertTab(index, window->getTitle());
+
 	setTabData(index, window->getIdentifier());
 
-	connect(window, SIGNAL(iconChanged(QIcon)), this, SLOT(updateTabs()));
-	connect(window, SIGNAL(loadingStateChanged(WindowsManager::LoadingState)), this, SLOT(updateTabs()));
+	TabState &state(m_tabs[index]);
+	state.window = window;
+	state.icon = window->getIcon();
+	state.title = window->getTitle();
+	state.loadingState = window->getLoadingState();
+	state.isPinned = window->isPinned();
+	state.isPrivate = window->isPrivate();
+
+	m_tabIndexes[window] = index;
+
+	connect(window, SIGNAL(titleChanged(QString)), this, SLOT(updateTitle(QString)));
+	connect(window, SIGNAL(iconChanged(QIcon)), this, SLOT(updateIcon(QIcon)));
+	connect(window, SIGNAL(loadingStateChanged(WindowsManager::LoadingState)), this, SLOT(updateLoadingState(WindowsManager::LoadingState)));
 	connect(window, SIGNAL(isPinnedChanged(bool)), this, SLOT(isPinnedChanged()));
 
 	if (window->isPinned())
@@ -466,7 +544,7 @@ void TabBarWidget::showPreview(int index)
 		QRect rectangle(tabRect(index));
 		rectangle.moveTo(mapToGlobal(rectangle.topLeft()));
 
-		m_previewWidget->setPreview(getTabProperty(index, QLatin1String("title"), tr("(Untitled)")).toString(), ((index == currentIndex()) ? QPixmap() : getTabProperty(index, QLatin1String("thumbnail"), QPixmap()).value<QPixmap>()));
+		m_previewWidget->setPreview((m_tabs.at(index).title.isEmpty() ? tr("(Untitled)") : m_tabs.at(index).title), ((index == currentIndex()) ? QPixmap() : getTabProperty(index, QLatin1String("thumbnail"), QPixmap()).value<QPixmap>()));
 
 		switch (shape())
 		{
@@ -646,11 +724,23 @@ void TabBarWidget::currentTabChanged(int index)
 
 void TabBarWidget::isPinnedChanged(Window *window)
 {
+	if (!window)
+	{
+		window = qobject_cast<Window*>(sender());
+	}
+
+	const int index(getTabIndex(window));
+
+	if (index >= 0)
+	{
+		m_tabs[index].isPinned = window->isPinned();
+	}
+
 	int amount(0);
 
-	for (int i = 0; i < count(); ++i)
+	for (int i = 0; i < m_tabs.count(); ++i)
 	{
-		if (getTabProperty(i, QLatin1String("isPinned"), false).toBool())
+		if (m_tabs.at(i).isPinned)
 		{
 			++amount;
 		}
@@ -658,25 +748,8 @@ void TabBarWidget::isPinnedChanged(Window *window)
 
 	m_pinnedTabsAmount = amount;
 
-	if (!window)
-	{
-		window = qobject_cast<Window*>(sender());
-	}
-
 	if (window)
 	{
-		int index(-1);
-
-		for (int i = 0; i < count(); ++i)
-		{
-			if (tabData(i).toULongLong() == window->getIdentifier())
-			{
-				index = i;
-
-				break;
-			}
-		}
-
 		if (index >= 0)
 		{
 			moveTab(index, (window->isPinned() ? qMax(0, (m_pinnedTabsAmount - 1)) : m_pinnedTabsAmount));
@@ -689,6 +762,35 @@ void TabBarWidget::isPinnedChanged(Window *window)
 	updateTabs();
 }
 
+void TabBarWidget::moveTabState(int from, int to)
+{
+	if (from >= 0 && from < m_tabs.count() && to >= 0 && to < m_tabs.count())
+	{
+		const TabState state(m_tabs.at(from));
+
+		m_tabs.remove(from);
+		m_tabs.insert(to, state);
+
+		updateTabIndexes(qMin(from, to), qMax(from, to));
+	}
+}
+
+void TabBarWidget::updateTabIndexes(int from, int to)
+{
+	if (to < 0 || to >= m_tabs.count())
+	{
+		to = (m_tabs.count() - 1);
+	}
+
+	for (int i = qMax(0, from); i <= to; ++i)
+	{
+		if (m_tabs.at(i).window)
+		{
+			m_tabIndexes[m_tabs.at(i).window.data()] = i;
+		}
+	}
+}
+
 void TabBarWidget::updateButtons()
 {
 	const QSize size(tabSizeHint(count() - 1));
@@ -700,7 +802,7 @@ void TabBarWidget::updateButtons()
 		QLabel *closeLabel(qobject_cast<QLabel*>(tabButton(i, m_closeButtonPosition)));
 		QLabel *iconLabel(qobject_cast<QLabel*>(tabButton(i, m_iconButtonPosition)));
 		const bool isCurrent(i == currentIndex());
-		const bool isPinned(getTabProperty(i, QLatin1String("isPinned"), false).toBool());
+		const bool isPinned(m_tabs.at(i).isPinned);
 
 		if (iconLabel)
 		{
@@ -755,48 +857,27 @@ void TabBarWidget::updateButtons()
 
 void TabBarWidget::updateTabs(int index)
 {
-	if (index < 0 && sender() && sender()->inherits(QStringLiteral("Otter::Window").toLatin1()))
-	{
-		for (int i = 0; i < count(); ++i)
-		{
-			if (sender() == getWindow(i))
-			{
-				index = i;
-
-				break;
-			}
-		}
-	}
-
-	const int limit((index >= 0) ? (index + 1) : count());
+	const int limit((index >= 0) ? qMin((index + 1), m_tabs.count()) : m_tabs.count());
 
 	for (int i = ((index >= 0) ? index : 0); i < limit; ++i)
 	{
-		const WindowsManager::LoadingState loadingState(static_cast<WindowsManager::LoadingState>(getTabProperty(i, QLatin1String("loadingState"), WindowsManager::FinishedLoadingState).toInt()));
+		const TabState &state(m_tabs.at(i));
+		const WindowsManager::LoadingState loadingState(state.loadingState);
 		QLabel *label(qobject_cast<QLabel*>(tabButton(i, m_iconButtonPosition)));
 
 		if (label)
 		{
 			if (loadingState == WindowsManager::DelayedLoadingState || loadingState == WindowsManager::OngoingLoadingState)
 			{
-				if (!label->movie())
-				{
-					QMovie *movie(new QMovie(QLatin1String(":/icons/loading.gif"), QByteArray(), label));
-					movie->start();
+				label->setPixmap(getThrobberFrame(loadingState));
 
-					label->setMovie(movie);
+				if (m_throbberTimer == 0)
+				{
+					m_throbberTimer = startTimer(m_throbberDelay);
 				}
-
-				label->movie()->setSpeed((loadingState == WindowsManager::OngoingLoadingState) ? 100 : 10);
 			}
 			else
 			{
-				if (label->movie())
-				{
-					label->movie()->deleteLater();
-					label->setMovie(NULL);
-				}
-
 				QIcon icon;
 
 				if (loadingState == WindowsManager::CrashedLoadingState)
@@ -805,7 +886,7 @@ void TabBarWidget::updateTabs(int index)
 				}
 				else
 				{
-					icon = getTabProperty(i, QLatin1String("icon"), ThemesManager::getIcon(getTabProperty(i, QLatin1String("isPrivate"), false).toBool() ? QLatin1String("tab-private") : QLatin1String("tab"))).value<QIcon>();
+					icon = (state.icon.isNull() ? ThemesManager::getIcon(state.isPrivate ? QLatin1String("tab-private") : QLatin1String("tab")) : state.icon);
 				}
 
 				label->setPixmap(icon.pixmap(16, 16));
@@ -818,6 +899,40 @@ void TabBarWidget::updateTabs(int index)
 	tabHovered(tabAt(mapFromGlobal(QCursor::pos())));
 }
 
+void TabBarWidget::updateTitle(const QString &title)
+{
+	const int index(getTabIndex(qobject_cast<Window*>(sender())));
+
+	if (index >= 0)
+	{
+		m_tabs[index].title = title;
+	}
+}
+
+void TabBarWidget::updateIcon(const QIcon &icon)
+{
+	const int index(getTabIndex(qobject_cast<Window*>(sender())));
+
+	if (index >= 0)
+	{
+		m_tabs[index].icon = icon;
+
+		updateTabs(index);
+	}
+}
+
+void TabBarWidget::updateLoadingState(WindowsManager::LoadingState state)
+{
+	const int index(getTabIndex(qobject_cast<Window*>(sender())));
+
+	if (index >= 0)
+	{
+		m_tabs[index].loadingState = state;
+
+		updateTabs(index);
+	}
+}
+
 void TabBarWidget::setCycle(bool enable)
 {
 	SettingsManager::setValue(QLatin1String("TabBar/RequireModifierToSwitchTabOnScroll"), !enable);
@@ -855,29 +970,49 @@ void TabBarWidget::setShape(QTabBar::Shape shape)
 
 Window* TabBarWidget::getWindow(int index) const
 {
-	if (index < 0 || index >= count())
+	if (index < 0 || index >= m_tabs.count())
 	{
 		return NULL;
 	}
 
-	MainWindow *mainWindow(MainWindow::findMainWindow(parentWidget()));
-
-	if (mainWindow)
-	{
-		return mainWindow->getWindowsManager()->getWindowByIdentifier(tabData(index).toULongLong());
-	}
-
-	return NULL;
+	return m_tabs.at(index).window.data();
 }
 
 QVariant TabBarWidget::getTabProperty(int index, const QString &key, const QVariant &defaultValue) const
 {
-	if (index < 0 || index >= count())
+	if (index < 0 || index >= m_tabs.count())
 	{
 		return defaultValue;
 	}
 
-	Window *window(getWindow(index));
+	const TabState &state(m_tabs.at(index));
+
+	if (key == QLatin1String("isPinned"))
+	{
+		return state.isPinned;
+	}
+
+	if (key == QLatin1String("isPrivate"))
+	{
+		return state.isPrivate;
+	}
+
+	if (key == QLatin1String("loadingState"))
+	{
+		return state.loadingState;
+	}
+
+	if (key == QLatin1String("icon"))
+	{
+		return (state.icon.isNull() ? defaultValue : QVariant(state.icon));
+	}
+
+	if (key == QLatin1String("title"))
+	{
+		return (state.title.isEmpty() ? defaultValue : QVariant(state.title));
+	}
+
+	Window *window(state.window.data());
 
 	if (window)
 	{
@@ -896,7 +1031,7 @@ QSize TabBarWidget::tabSizeHint(int index) const
 {
 	const bool isHorizontal(shape() == QTabBar::RoundedNorth || shape() == QTabBar::RoundedSouth);
 
-	if (isHorizontal && getTabProperty(index, QLatin1String("isPinned"), false).toBool())
+	if (isHorizontal && index >= 0 && index < m_tabs.count() && m_tabs.at(index).isPinned)
 	{
 		return QSize(m_minimumTabSize, QTabBar::tabSizeHint(0).height());
 	}
@@ -922,9 +1057,9 @@ QSize TabBarWidget::sizeHint() const
 	{
 		int size(0);
 
-		for (int i = 0; i < count(); ++i)
+		for (int i = 0; i < m_tabs.count(); ++i)
 		{
-			size += (getTabProperty(i, QLatin1String("isPinned"), false).toBool() ? m_minimumTabSize : m_maximumTabSize);
+			size += (m_tabs.at(i).isPinned ? m_minimumTabSize : m_maximumTabSize);
 		}
 
 		return QSize(size, QTabBar::sizeHint().height());
@@ -933,6 +1068,50 @@ QSize TabBarWidget::sizeHint() const
 	return QSize(QTabBar::sizeHint().width(), (tabSizeHint(0).height() * count()));
 }
 
+QPixmap TabBarWidget::getThrobberFrame(WindowsManager::LoadingState state)
+{
+	if (m_throbberFrames.isEmpty())
+	{
+		QImageReader reader(QLatin1String(":/icons/loading.gif"));
+
+		while (reader.canRead())
+		{
+			const QImage image(reader.read());
+
+			if (image.isNull())
+			{
+				break;
+			}
+
+			if (m_throbberFrames.isEmpty() && reader.nextImageDelay() > 0)
+			{
+				m_throbberDelay = reader.nextImageDelay();
+			}
+
+			m_throbberFrames.append(QPixmap::fromImage(image));
+		}
+
+		if (m_throbberFrames.isEmpty())
+		{
+			return QPixmap();
+		}
+	}
+
+	return m_throbberFrames.at(((state == WindowsManager::DelayedLoadingState) ? (m_throbberStep / 10) : m_throbberStep) % m_throbberFrames.count());
+}
+
+int TabBarWidget::getTabIndex(Window *window) const
+{
+	if (!window)
+	{
+		return -1;
+	}
+
+	const int index(m_tabIndexes.value(window, -1));
+
+	return ((index >= 0 && index < m_tabs.count() && m_tabs.at(index).window == window) ? index : -1);
+}
+
 int TabBarWidget::getPinnedTabsAmount() const
 {
 	return m_pinnedTabsAmount;
@@ -21,6 +21,11 @@
 #ifndef OTTER_TABBARWIDGET_H
 #define OTTER_TABBARWIDGET_H
 
+#include "../core/WindowsManager.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtGui/QIcon>
 #include <QtWidgets/QTabBar>
 
 namespace Otter
@@ -63,22 +68,44 @@ protected:
 	void showPreview(int index);
 	void hidePreview();
 	QSize tabSizeHint(int index) const;
+	void updateTabIndexes(int from, int to = -1);
+	QPixmap getThrobberFrame(WindowsManager::LoadingState state);
+	int getTabIndex(Window *window) const;
 	bool event(QEvent *event);
 
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
 	void currentTabChanged(int index);
 	void isPinnedChanged(Window *window = NULL);
+	void moveTabState(int from, int to);
 	void updateButtons();
 	void updateTabs(int index = -1);
+	void updateTitle(const QString &title);
+	void updateIcon(const QIcon &icon);
+	void updateLoadingState(WindowsManager::LoadingState state);
 	void setCycle(bool enable);
 	void setArea(Qt::ToolBarArea area);
 	void setShape(QTabBar::Shape shape);
 
 private:
+	struct TabState
+	{
+		QPointer<Window> window;
+		QIcon icon;
+		QString title;
+		WindowsManager::LoadingState loadingState;
+		bool isPinned;
+		bool isPrivate;
+
+		TabState() : loadingState(WindowsManager::FinishedLoadingState), isPinned(false), isPrivate(false) {}
+	};
+
 	PreviewWidget *m_previewWidget;
 	QTabBar::ButtonPosition m_closeButtonPosition;
 	QTabBar::ButtonPosition m_iconButtonPosition;
+	QVector<TabState> m_tabs;
+	QHash<Window*, int> m_tabIndexes;
+	QVector<QPixmap> m_throbberFrames;
 	int m_tabSize;
 	int m_maximumTabSize;
 	int m_minimumTabSize;
@@ -86,6 +113,9 @@ private:
 	int m_clickedTab;
 	int m_hoveredTab;
 	int m_previewTimer;
+	int m_throbberTimer;
+	int m_throbberStep;
+	int m_throbberDelay;
 	bool m_showCloseButton;
 	bool m_showUrlIcon;
 	bool m_enablePreviews;
@@ -100,6 +100,7 @@ public:
 		BytesReceivedInformation,
 		BytesTotalInformation,
 		RequestsBlockedInformation,
+		RequestsBlockingTimeInformation,
 		RequestsFinishedInformation,
 		RequestsStartedInformation,
 		LoadingSpeedInformation,
@@ -84,6 +84,13 @@ WebsiteInformationDialog::WebsiteInformationDialog(WebWidget *widget, QWidget *p
 	m_ui->encodingLabelWidget->setText(characterEncoding.isEmpty() ? tr("unknown") : characterEncoding);
 	m_ui->sizeLabelWidget->setText(Utils::formatUnit(widget->getPageInformation(WebWidget::BytesTotalInformation).toLongLong(), false, 1, true));
 	m_ui->elementsLabelWidget->setText((widget->getPageInformation(WebWidget::RequestsBlockedInformation).toInt() > 0) ? tr("%1 (%n blocked)", "", widget->getPageInformation(WebWidget::RequestsBlockedInformation).toInt()).arg(widget->getPageInformation(WebWidget::RequestsStartedInformation).toInt()) : QString::number(widget->getPageInformation(WebWidget::RequestsStartedInformation).toInt()));
+
+	const QVariant blockingTime(widget->getPageInformation(WebWidget::RequestsBlockingTimeInformation));
+
+	if (!blockingTime.isNull())
+	{
+		m_ui->elementsLabelWidget->setToolTip(tr("Time spent on content blocking: %1 ms").arg(QString::number((blockingTime.toLongLong() / 1000000.0), 'f', 2)));
+	}
 	m_ui->downloadDateLabelWidget->setText(Utils::formatDateTime(widget->getPageInformation(WebWidget::LoadingFinishedInformation).toDateTime()));
 
 	const QString cookiesPolicy(widget->getOption(QLatin1String("Network/CookiesPolicy")).toString());
@@ -31,6 +31,7 @@
 #include "../core/Utils.h"
 #include "../modules/windows/addons/AddonsContentsWidget.h"
 #include "../modules/windows/bookmarks/BookmarksContentsWidget.h"
+#include "../modules/windows/blocking/ContentBlockingContentsWidget.h"
 #include "../modules/windows/cache/CacheContentsWidget.h"
 #include "../modules/windows/cookies/CookiesContentsWidget.h"
 #include "../modules/windows/configuration/ConfigurationContentsWidget.h"
@@ -422,6 +423,10 @@ void Window::setUrl(const QUrl &url, bool typed)
 		{
 			newWidget = new AddonsContentsWidget(this);
 		}
+		else if (url.path() == QLatin1String("blocking"))
+		{
+			newWidget = new ContentBlockingContentsWidget(this);
+		}
 		else if (url.path() == QLatin1String("bookmarks"))
 		{
 			newWidget = new BookmarksContentsWidget(this);
@@ -31,6 +31,7 @@
 #include "../../core/BookmarksManager.h"
 #include "../../core/InputInterpreter.h"
 #include "../../core/HistoryManager.h"
+#include "../../core/HostResolver.h"
 #include "../../core/SearchEnginesManager.h"
 #include "../../core/ThemesManager.h"
 #include "../../core/Utils.h"
@@ -46,6 +47,9 @@
 #include <QtWidgets/QStyleOptionFrame>
 #include <QtWidgets/QToolTip>
 
+#define ADDRESSWIDGET_HOST_LOOKUP_DELAY 200
+#define ADDRESSWIDGET_HOST_PREFETCH_AMOUNT 3
+
 namespace Otter
 {
 
@@ -61,6 +65,7 @@ AddressWidget::AddressWidget(Window *window, QWidget *parent) : QComboBox(parent
 	m_completionModes(NoCompletionMode),
 	m_hints(WindowsManager::DefaultOpen),
 	m_removeModelTimer(0),
+	m_hostLookupTimer(0),
 	m_isHistoryDropdownEnabled(SettingsManager::getValue(QLatin1String("AddressField/EnableHistoryDropdown")).toBool()),
 	m_isUsingSimpleMode(false),
 	m_wasPopupVisible(false)
@@ -105,6 +110,7 @@ AddressWidget::AddressWidget(Window *window, QWidget *parent) : QComboBox(parent
 
 	connect(this, SIGNAL(activated(QString)), this, SLOT(openUrl(QString)));
 	connect(m_lineEdit, SIGNAL(textDropped(QString)), this, SLOT(handleUserInput(QString)));
+	connect(m_lineEdit, SIGNAL(textEdited(QString)), this, SLOT(scheduleHostLookup()));
 	connect(m_completionModel, SIGNAL(completionReady(QString)), this, SLOT(setCompletion(QString)));
 	connect(BookmarksManager::getModel(), SIGNAL(modelModified()), this, SLOT(updateBookmark()));
 	connect(HistoryManager::getTypedHistoryModel(), SIGNAL(modelModified()), this, SLOT(updateLineEdit()));
@@ -135,6 +141,19 @@ void AddressWidget::timerEvent(QTimerEvent *event)
 
 		m_lineEdit->setText(text);
 	}
+	else if (event->timerId() == m_hostLookupTimer)
+	{
+		killTimer(m_hostLookupTimer);
+
+		m_hostLookupTimer = 0;
+
+		const QString text(m_lineEdit->text().trimmed());
+
+		if (!text.isEmpty() && !text.contains(QLatin1Char(' ')) && SearchEnginesManager::getSearchEngine(text, true).identifier.isEmpty())
+		{
+			prefetchHost(QUrl::fromUserInput(text).host());
+		}
+	}
 }
 
 void AddressWidget::paintEvent(QPaintEvent *event)
@@ -658,6 +677,29 @@ void AddressWidget::handleUserInput(const QString &text, WindowsManager::OpenHin
 	}
 }
 
+void AddressWidget::scheduleHostLookup()
+{
+	if (m_hostLookupTimer != 0)
+	{
+		killTimer(m_hostLookupTimer);
+
+		m_hostLookupTimer = 0;
+	}
+
+	if (m_window && !m_window->isPrivate() && SettingsManager::getValue(QLatin1String("AddressField/HostLookupTimeout")).toInt() > 0)
+	{
+		m_hostLookupTimer = startTimer(ADDRESSWIDGET_HOST_LOOKUP_DELAY);
+	}
+}
+
+void AddressWidget::prefetchHost(const QString &host)
+{
+	if (m_window && !m_window->isPrivate() && !host.isEmpty() && !host.contains(QLatin1Char('.')) && !host.contains(QLatin1Char(':')))
+	{
+		HostResolver::resolveHost(host);
+	}
+}
+
 void AddressWidget::updateBookmark(const QUrl &url)
 {
 	if (!m_bookmarkLabel)
@@ -813,6 +855,14 @@ void AddressWidget::setCompletion(const QString &filter)
 		return;
 	}
 
+	if (SettingsManager::getValue(QLatin1String("AddressField/HostLookupTimeout")).toInt() > 0)
+	{
+		for (int i = 0; i < qMin(m_completionModel->rowCount(), ADDRESSWIDGET_HOST_PREFETCH_AMOUNT); ++i)
+		{
+			prefetchHost(m_completionModel->index(i).data(AddressCompletionModel::UrlRole).toUrl().host());
+		}
+	}
+
 	if (m_completionModes.testFlag(PopupCompletionMode))
 	{
 		if (!m_completionView)
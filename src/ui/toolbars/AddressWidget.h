@@ -78,6 +78,7 @@ protected:
 	void mouseMoveEvent(QMouseEvent *event);
 	void mouseReleaseEvent(QMouseEvent *event);
 	void wheelEvent(QWheelEvent *event);
+	void prefetchHost(const QString &host);
 	bool startDrag(QMouseEvent *event);
 
 protected slots:
@@ -86,6 +87,7 @@ protected slots:
 	void openUrl(const QString &url);
 	void openUrl(const QModelIndex &index);
 	void removeIcon();
+	void scheduleHostLookup();
 	void updateBookmark(const QUrl &url = QUrl());
 	void updateFeeds();
 	void updateLoadPlugins();
@@ -112,6 +114,7 @@ private:
 	AddressWidget::CompletionModes m_completionModes;
 	WindowsManager::OpenHints m_hints;
 	int m_removeModelTimer;
+	int m_hostLookupTimer;
 	bool m_isHistoryDropdownEnabled;
 	bool m_isUsingSimpleMode;
 	bool m_wasPopupVisible;
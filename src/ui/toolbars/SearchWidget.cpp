@@ -329,6 +329,7 @@ void SearchWidget::optionChanged(const QString &option, const QVariant &value)
 		if (value.toBool() && !m_suggester)
 		{
 			m_suggester = new SearchSuggester(getCurrentSearchEngine(), this);
+			m_suggester->setPrivate(isPrivate());
 
 			m_completer->setModel(m_suggester->getModel());
 
@@ -573,6 +574,11 @@ void SearchWidget::setWindow(Window *window)
 
 		setSearchEngine();
 	}
+
+	if (m_suggester)
+	{
+		m_suggester->setPrivate(isPrivate());
+	}
 }
 
 QString SearchWidget::getCurrentSearchEngine() const
@@ -585,4 +591,16 @@ QVariantMap SearchWidget::getOptions() const
 	return m_options;
 }
 
+bool SearchWidget::isPrivate() const
+{
+	if (m_window)
+	{
+		return m_window->isPrivate();
+	}
+
+	MainWindow *mainWindow(MainWindow::findMainWindow(parentWidget()));
+
+	return (SessionsManager::isPrivate() || (mainWindow && mainWindow->getWindowsManager()->isPrivate()));
+}
+
 }
@@ -44,6 +44,7 @@ public:
 	void hidePopup();
 	QString getCurrentSearchEngine() const;
 	QVariantMap getOptions() const;
+	bool isPrivate() const;
 
 public slots:
 	void activate(Qt::FocusReason reason);